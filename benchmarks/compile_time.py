@@ -0,0 +1,69 @@
+
+"""
+    Copyright Kristjan Kongas 2020
+
+    Boost Software License - Version 1.0 - August 17th, 2003
+
+    Permission is hereby granted, free of charge, to any person or organization
+    obtaining a copy of the software and accompanying documentation covered by
+    this license (the "Software") to use, reproduce, display, distribute,
+    execute, and transmit the Software, and to prepare derivative works of the
+    Software, and to permit third-parties to whom the Software is furnished to
+    do so, all subject to the following:
+
+    The copyright notices in the Software and this entire statement, including
+    the above license grant, this restriction and the following disclaimer,
+    must be included in all copies of the Software, in whole or in part, and
+    all derivative works of the Software, unless such copies or derivative
+    works are solely in the form of machine-executable object code generated by
+    a source language processor.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+    SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+    FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+"""
+
+import argparse, os, subprocess, time
+from pathlib import Path
+
+description = """Measures the compile time of a translation unit using fire.hpp (examples/basic.cpp), header-only and with
+FIRE_LIBRARY, where non-template code is compiled once in src/fire.cpp instead."""
+
+
+def compile_time(cxx, flags, source, repeats):
+    best = float("inf")
+    for _ in range(repeats):
+        start = time.perf_counter()
+        subprocess.run([cxx] + flags + ["-c", str(source), "-o", os.devnull], check=True)
+        best = min(best, time.perf_counter() - start)
+    return best
+
+
+def main():
+    parser = argparse.ArgumentParser(description=description)
+    parser.add_argument("--cxx", default=os.environ.get("CXX", "c++"), help="compiler (default: $CXX or c++)")
+    parser.add_argument("--std", default="11", help="C++ standard (default: 11)")
+    parser.add_argument("--repeats", type=int, default=3, help="compilations per measurement, the fastest is used")
+    parser.add_argument("--units", type=int, default=400, help="translation units in the estimated project total")
+    args = parser.parse_args()
+
+    root = Path(__file__).absolute().parent.parent
+    tu, library = root / "examples" / "basic.cpp", root / "src" / "fire.cpp"
+
+    print("{:<6} {:>16} {:>16} {:>16} {:>22}".format("flags", "header-only [s]", "FIRE_LIBRARY [s]", "fire.cpp [s]",
+                                                      "{} units [s]".format(args.units)))
+    for opt in ["-O0", "-O2"]:
+        flags = ["-std=c++" + args.std, opt, "-I", str(root / "include")]
+        header_only = compile_time(args.cxx, flags, tu, args.repeats)
+        declarations = compile_time(args.cxx, flags + ["-DFIRE_LIBRARY"], tu, args.repeats)
+        once = compile_time(args.cxx, flags, library, args.repeats)
+        total = "{:.1f} -> {:.1f}".format(args.units * header_only, args.units * declarations + once)
+        print("{:<6} {:>16.3f} {:>16.3f} {:>16.3f} {:>22}".format(opt, header_only, declarations, once, total))
+
+
+if __name__ == "__main__":
+    main()
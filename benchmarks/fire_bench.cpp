@@ -0,0 +1,229 @@
+
+/*
+    Copyright (c) 2020 Kristjan Kongas
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose with or without fee is hereby granted.
+
+    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH
+    REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY
+    AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+    INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+    LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR
+    OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+    PERFORMANCE OF THIS SOFTWARE.
+*/
+
+// Measures parsing latency and allocations of typical and extreme command lines. Every scenario runs
+// fire::parser over a generated command line with a generated fired_main, at growing sizes, so the ns/arg
+// column shows how the cost scales. Usage: fire_bench [--max-size=N] [--min-time=SECONDS] [--scenario=NAME]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include "fire-hpp/fire.hpp"
+
+using namespace std;
+
+static size_t allocations = 0, allocated_bytes = 0;
+
+void* operator new(size_t size) {
+    ++allocations;
+    allocated_bytes += size;
+    if(void *p = malloc(size ? size : 1))
+        return p;
+    throw bad_alloc();
+}
+void operator delete(void *p) noexcept { free(p); }
+void operator delete(void *p, size_t) noexcept { free(p); }
+
+// State of the running scenario, read by the generated fired_main functions
+static int size;
+static vector<string> names;
+
+static int named_main() {
+    long long sum = 0;
+    for(const string &name: names)
+        sum += (int) fire::arg(name.c_str());
+    return sum == (long long) size * (size - 1) / 2 ? 0 : 1;
+}
+
+static int flag_main() {
+    int count = 0;
+    for(const string &name: names)
+        count += (bool) fire::arg(name.c_str());
+    return count == size ? 0 : 1;
+}
+
+template <typename T>
+static int variadic_main() {
+    vector<T> values = fire::arg(fire::variadic());
+    return values.size() == (size_t) size ? 0 : 1;
+}
+
+struct scenario {
+    const char *name, *description;
+    int (*fired_main)();
+    int main_args; // -1 if fired_main queries every name
+    vector<int> sizes;
+    vector<string> (*command_line)(int size); // Also fills names
+};
+
+static vector<string> named_line(int n) {
+    vector<string> args = {"fire_bench"};
+    for(int i = 0; i < n; ++i) {
+        names.push_back("--option" + to_string(i));
+        args.push_back(names.back() + "=" + to_string(i));
+    }
+    return args;
+}
+
+static vector<string> flag_line(int n) {
+    vector<string> args = {"fire_bench"};
+    for(int i = 0; i < n; ++i) {
+        names.push_back("--flag" + to_string(i));
+        args.push_back(names.back());
+    }
+    return args;
+}
+
+static vector<string> expansion_line(int n) { // -abcd -efgh ...
+    const string letters = "abcdefgijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ"; // Without -h
+    vector<string> args = {"fire_bench"};
+    for(int i = 0; i < n; ++i) {
+        names.push_back(string("-") + letters[i]);
+        if(i % 4 == 0)
+            args.push_back("-");
+        args.back() += letters[i];
+    }
+    return args;
+}
+
+static vector<string> rewrite_line(int n) { // --option0 0 --option1 1 ..., rewritten like `-j 8`
+    vector<string> args = {"fire_bench"};
+    for(int i = 0; i < n; ++i) {
+        names.push_back("--option" + to_string(i));
+        args.push_back(names.back());
+        args.push_back(to_string(i));
+    }
+    return args;
+}
+
+static vector<string> int_line(int n) {
+    vector<string> args = {"fire_bench"};
+    for(int i = 0; i < n; ++i)
+        args.push_back(to_string(i * 7919 - 500000));
+    return args;
+}
+
+static vector<string> double_line(int n) {
+    vector<string> args = {"fire_bench"};
+    for(int i = 0; i < n; ++i)
+        args.push_back(to_string(i) + "." + to_string(i % 1000) + "e-3");
+    return args;
+}
+
+static vector<string> string_line(int n) {
+    vector<string> args = {"fire_bench"};
+    for(int i = 0; i < n; ++i)
+        args.push_back("file" + to_string(i) + ".txt");
+    return args;
+}
+
+static const vector<int> sizes = {10, 100, 1000, 10000};
+static const vector<int> variadic_sizes = {10, 1000, 100000, 1000000};
+
+static const vector<scenario> scenarios = {
+    {"named", "--option<i>=<i>, converted to int", named_main, -1, sizes, named_line},
+    {"flags", "--flag<i>, converted to bool", flag_main, -1, sizes, flag_line},
+    {"expansion", "-abcd expanded to single-character flags", flag_main, -1, {12, 24, 48}, expansion_line},
+    {"rewrite", "--option<i> <i>, rewritten to --option<i>=<i>", named_main, -1, sizes, rewrite_line},
+    {"ints", "variadic int", variadic_main<int>, 1, variadic_sizes, int_line},
+    {"doubles", "variadic double", variadic_main<double>, 1, variadic_sizes, double_line},
+    {"strings", "variadic std::string", variadic_main<std::string>, 1, variadic_sizes, string_line},
+};
+
+struct measurement {
+    double ns;
+    double allocations, bytes;
+};
+
+template <typename F>
+static measurement measure(double min_time, F f) {
+    f(); // Warm up
+    size_t runs = 0, start_allocations = allocations, start_bytes = allocated_bytes;
+    auto start = chrono::steady_clock::now();
+    double elapsed;
+    do {
+        f();
+        ++runs;
+        elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    } while(elapsed < min_time);
+    return {elapsed * 1e9 / (double) runs, (double) (allocations - start_allocations) / (double) runs,
+            (double) (allocated_bytes - start_bytes) / (double) runs};
+}
+
+static void print(const char *name, int n, const measurement &m) {
+    printf("%-10s %8d %14.1f %10.1f %12.1f %12.1f\n", name, n, m.ns / 1000, m.ns / n, m.allocations, m.bytes / n);
+}
+
+static measurement run_scenario(const scenario &s, int n, double min_time) {
+    names.clear();
+    size = n;
+    vector<string> args = s.command_line(n);
+    vector<const char *> argv;
+    for(const string &arg: args)
+        argv.push_back(arg.c_str());
+    int main_args = s.main_args >= 0 ? s.main_args : (int) names.size();
+
+    fire::parser parser((int) argv.size(), argv.data());
+    return measure(min_time, [&] {
+        if(parser.run(main_args, "", s.fired_main) != 0)
+            exit(1);
+    });
+}
+
+static measurement run_help(int n, double min_time) { // Rendering of --help for n options
+    names.clear();
+    named_line(n);
+    fire::_::logger() = fire::_arg_logger();
+    for(const string &name: names)
+        fire::_::logger().log(fire::identifier({name, "Description of " + name}, fire::optional<int>()),
+                              {"Description of " + name, fire::_arg_logger::elem::type::integer, "", false});
+
+    // Help is written to stderr, which is discarded meanwhile
+    fflush(stderr);
+    int previous = dup(2), discard = open("/dev/null", O_WRONLY);
+    dup2(discard, 2);
+    measurement m = measure(min_time, [] { fire::_::logger().print_help(); });
+    dup2(previous, 2);
+    close(discard);
+    close(previous);
+    return m;
+}
+
+int fired_main(int max_size = fire::arg({"--max-size", "Largest size of a scenario"}, 1000000),
+               double min_time = fire::arg({"--min-time", "Minimum seconds spent per measurement"}, 0.2),
+               string only = fire::arg({"--scenario", "Run only this scenario (or help)"}, "")) {
+    printf("%-10s %8s %14s %10s %12s %12s\n", "scenario", "args", "us/parse", "ns/arg", "allocs/parse", "bytes/arg");
+    for(const scenario &s: scenarios) {
+        if(! only.empty() && only != s.name)
+            continue;
+        for(int n: s.sizes)
+            if(n <= max_size)
+                print(s.name, n, run_scenario(s, n, min_time));
+    }
+
+    if(only.empty() || only == "help")
+        for(int n: sizes)
+            if(n <= max_size)
+                print("help", n, run_help(n, min_time));
+    return 0;
+}
+
+FIRE(fired_main, "Parsing latency and allocation benchmarks")
@@ -0,0 +1,89 @@
+
+/*
+    Copyright (c) 2020 Kristjan Kongas
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose with or without fee is hereby granted.
+
+    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH
+    REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY
+    AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+    INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+    LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR
+    OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+    PERFORMANCE OF THIS SOFTWARE.
+*/
+
+// Compares _matcher::scan(), which classifies all tokens in one pass over the argv block,
+// with the per-token passes the parser used before (hyphen counting and '=' search in every stage)
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "fire-hpp/fire.hpp"
+
+using namespace std;
+using namespace fire;
+
+static volatile size_t sink;
+
+template <typename F>
+static double ns_per_token(size_t tokens, F f) {
+    size_t runs = 1;
+    while(true) {
+        auto start = chrono::steady_clock::now();
+        for(size_t i = 0; i < runs; ++i)
+            f();
+        double ns = (double) chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count();
+        if(ns > 2e8)
+            return ns / (double) (runs * tokens);
+        runs *= 2;
+    }
+}
+
+static size_t per_token_passes(const _arena_vector<_string_view> &raw) {
+    size_t checksum = 0;
+    for(const _string_view &s: raw) // equate_assignments
+        checksum += (size_t) count_hyphens(s) + (s == "--");
+    for(const _string_view &s: raw) // separate_named_positional
+        checksum += (size_t) count_hyphens(s) + (s == "--");
+    for(const _string_view &s: raw) // expand_single_hyphen
+        checksum += (size_t) count_hyphens(s) + s.find('=');
+    for(const _string_view &s: raw) // assign_named_values
+        checksum += (size_t) count_hyphens(s) + s.find('=');
+    return checksum;
+}
+
+int main() {
+    const char *program[] = {"scan"};
+    printf("%8s %8s %14s %14s\n", "tokens", "length", "per-token ns", "scan ns");
+
+    for(size_t length: {4, 16, 64})
+        for(size_t n: {16, 256, 4096, 65536}) {
+            // Tokens like `--option=value`, `-abc` and positional values, stored back to back like argv
+            string block;
+            vector<size_t> offsets;
+            for(size_t i = 0; i < n; ++i) {
+                offsets.push_back(block.size());
+                string value(length, 'a' + (char) (i % 26));
+                if(i % 3 == 0) block += "--option" + to_string(i) + "=" + value;
+                else if(i % 3 == 1) block += "-" + value;
+                else block += value;
+                block += '\0';
+            }
+
+            _arena arena;
+            _matcher matcher(1, program, 0, false, false, &arena);
+            _arena_vector<_string_view> raw;
+            for(size_t offset: offsets)
+                raw.push_back(&block[offset]);
+
+            double before = ns_per_token(n, [&] { sink = per_token_passes(raw); });
+            double after = ns_per_token(n, [&] {
+                arena.reset(); // The matcher's own state is empty and not used afterwards
+                sink = matcher.scan(raw).size();
+            });
+            printf("%8zu %8zu %14.2f %14.2f\n", n, length, before, after);
+        }
+}
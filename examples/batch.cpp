@@ -0,0 +1,29 @@
+
+/*
+    Copyright (c) 2020 Kristjan Kongas
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose with or without fee is hereby granted.
+
+    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH
+    REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY
+    AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+    INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+    LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR
+    OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+    PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#include <iostream>
+#include "fire-hpp/fire.hpp"
+
+using namespace std;
+
+// Reads records of null-terminated arguments from stdin, each record ends with an empty argument
+// Eg. `printf -- '-x\0001\000\000-x=2\000-y=3\000\000' | ./batch`
+int fired_main(int x = fire::arg({"-x", "--first"}), int y = fire::arg({"-y", "--second"}, 0)) {
+    cout << x + y << endl;
+    return 0;
+}
+
+FIRE_BATCH(fired_main, "Sums -x and -y for every record")
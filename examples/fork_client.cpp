@@ -0,0 +1,35 @@
+
+/*
+    Copyright (c) 2020 Kristjan Kongas
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose with or without fee is hereby granted.
+
+    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH
+    REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY
+    AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+    INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+    LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR
+    OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+    PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#include <iostream>
+#include "fire-hpp/fire.hpp"
+
+using namespace std;
+
+// Usage: ./fork_client SOCKET [arguments...]
+int main(int argc, const char **argv) {
+    if(argc < 2) {
+        cerr << "Usage: " << argv[0] << " SOCKET [arguments...]" << endl;
+        return 1;
+    }
+
+    int code = fire::fork_client(argv[1], argc - 1, argv + 1);
+    if(code < 0) {
+        cerr << "Error: can't connect to " << argv[1] << endl;
+        return 1;
+    }
+    return code;
+}
@@ -33,14 +33,25 @@
 #define FIRE_HPP_
 
 #include <string>
+#ifndef FIRE_NO_IOSTREAM // Help and errors are written without iostreams, defining this avoids including them
 #include <iostream>
+#endif
+#include <iterator>
 #include <vector>
 #include <map>
+#include <memory>
 #include <unordered_map>
 #include <unordered_set>
 #include <cassert>
+#include <cctype>
+#include <cerrno>
+#include <cfloat>
+#include <cmath>
 #include <cstdlib>
 #include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
 #include <algorithm>
 #include <type_traits>
 #include <limits>
@@ -49,6 +60,76 @@
 #define FIRE_EXCEPTIONS_ENABLED_
 #endif
 
+#if defined(__SIZEOF_INT128__)
+#define FIRE_INT128_ENABLED_
+#endif
+
+#if __cplusplus >= 201402L
+#define FIRE_CONSTEXPR14_ constexpr
+#else
+#define FIRE_CONSTEXPR14_
+#endif
+
+#if __cplusplus >= 202002L && defined(__cpp_nontype_template_args) && __cpp_nontype_template_args >= 201911L
+#define FIRE_STATIC_IDENTIFIERS_ENABLED_
+#endif
+
+#ifdef FIRE_PARALLEL_CONVERSION // Convert large variadic arguments on multiple threads
+#include <thread>
+#ifndef FIRE_PARALLEL_THRESHOLD
+#define FIRE_PARALLEL_THRESHOLD 100000
+#endif
+#endif
+
+#ifdef FIRE_STATS // Profile parsing phases, printed if the FIRE_STATS environment variable is set
+#include <chrono>
+#define FIRE_STATS_PHASE_(phase) fire::_parse_stats::timer fire_stats_timer_(fire::_::stats(), fire::_parse_stats::phase)
+#else
+#define FIRE_STATS_PHASE_(phase)
+#endif
+
+#if (defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__) || defined(_MSC_VER)
+#define FIRE_LITTLE_ENDIAN_
+#endif
+
+#if defined(__unix__) || defined(__APPLE__)
+#define FIRE_MMAP_ENABLED_
+#define FIRE_FORK_SERVER_ENABLED_
+#define FIRE_WRITE_ENABLED_
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#if defined(__GNUC__) && defined(__AVX2__)
+#define FIRE_AVX2_ENABLED_
+#include <immintrin.h>
+#elif defined(__GNUC__) && defined(__SSE2__)
+#define FIRE_SSE2_ENABLED_
+#include <emmintrin.h>
+#endif
+
+#if defined(FLT_EVAL_METHOD) && (FLT_EVAL_METHOD < 0 || FLT_EVAL_METHOD > 1)
+#define FIRE_EXTENDED_FLOAT_EVAL_ // Eg. x87, where float and double expressions are computed in long double
+#endif
+
+// Non-template code is compiled in every translation unit by default. With FIRE_LIBRARY, only its declarations are
+// included, and it's compiled once in a translation unit defining FIRE_IMPLEMENTATION (the fire-hpp-lib target)
+#if defined(FIRE_IMPLEMENTATION)
+#define FIRE_API_
+#define FIRE_DEFINITIONS_ENABLED_
+#elif defined(FIRE_LIBRARY)
+#define FIRE_API_
+#else
+#define FIRE_API_ inline
+#define FIRE_DEFINITIONS_ENABLED_
+#endif
+
 namespace fire {
 
     static int argc;
@@ -59,10 +140,167 @@ namespace fire {
     template<typename R, typename ... Types>
     constexpr size_t _get_argument_count(R(*)(Types ...)) { return sizeof...(Types); }
 
-    inline void _instant_assert(bool pass, const std::string &msg, bool programmer_side = true);
-    inline int count_hyphens(const std::string &s);
-    inline std::string without_hyphens(const std::string &s);
-    inline std::string replace_all(const std::string &data, const std::string &from, const std::string &to);
+#ifdef FIRE_INT128_ENABLED_
+    __extension__ typedef __int128 _int128;
+    __extension__ typedef unsigned __int128 _uint128;
+#endif
+
+    template <typename T> // Integral types excluding bool, including 128-bit integers where available
+    struct _is_integer: std::integral_constant<bool, std::is_integral<T>::value && ! std::is_same<T, bool>::value> {};
+    template <typename T>
+    struct _make_unsigned { using type = typename std::make_unsigned<T>::type; };
+#ifdef FIRE_INT128_ENABLED_
+    template <> struct _is_integer<_int128>: std::true_type {};
+    template <> struct _is_integer<_uint128>: std::true_type {};
+    template <> struct _make_unsigned<_int128> { using type = _uint128; };
+    template <> struct _make_unsigned<_uint128> { using type = _uint128; };
+#endif
+
+    template <typename T>
+    struct _integer_traits { // std::numeric_limits isn't specialized for 128-bit integers in strict ISO mode
+        using U = typename _make_unsigned<T>::type;
+        static constexpr bool is_signed = T(-1) < T(0);
+        static constexpr int digits10 = (int) (sizeof(U) * 8 * 643 / 2136); // floor(bits * log10(2))
+        static constexpr U max() { return U(~U(0)); }
+        static constexpr U max_magnitude(bool negative) { return is_signed ? U((max() >> 1) + U(negative)) : max(); }
+    };
+
+    template <typename T>
+    struct _float_traits {
+        // W is the type in which the fast path computes: wider than T where possible, so that more inputs are exact.
+        // The fast path requires correctly rounded (IEEE) arithmetic in W.
+#ifdef FIRE_EXTENDED_FLOAT_EVAL_
+        using W = long double;
+#else
+        using wider_double = typename std::conditional<std::numeric_limits<long double>::is_iec559 &&
+                (std::numeric_limits<long double>::digits > std::numeric_limits<double>::digits), long double, double>::type;
+        using W = typename std::conditional<std::is_same<T, float>::value, double,
+                  typename std::conditional<std::is_same<T, double>::value, wider_double, T>::type>::type;
+#endif
+        static constexpr bool fast_path = std::numeric_limits<W>::is_iec559;
+        static constexpr int max_exact_pow10 = std::numeric_limits<W>::digits * 1000 / 2322; // Max k, 5^k < 2^digits
+#ifdef FIRE_EXTENDED_FLOAT_EVAL_
+        static constexpr bool fast_path_in_t = false;
+#else
+        static constexpr bool fast_path_in_t = std::numeric_limits<T>::is_iec559 && (std::numeric_limits<T>::digits < 64);
+#endif
+        static constexpr int max_exact_pow10_in_t = std::numeric_limits<T>::digits * 1000 / 2322;
+
+        static T pow10(int k) { // Exact for k <= max_exact_pow10_in_t
+            struct table {
+                T values[max_exact_pow10_in_t + 1];
+                table() {
+                    values[0] = 1;
+                    for(int i = 1; i <= max_exact_pow10_in_t; ++i)
+                        values[i] = values[i - 1] * 10;
+                }
+            };
+            static const table powers;
+            return powers.values[k];
+        }
+    };
+
+    inline void _strtofp(const char *str, float &value) { value = std::strtof(str, nullptr); }
+    inline void _strtofp(const char *str, double &value) { value = std::strtod(str, nullptr); }
+    inline void _strtofp(const char *str, long double &value) { value = std::strtold(str, nullptr); }
+
+    inline bool _swar_is_eight_digits(uint64_t chunk);
+    inline uint32_t _swar_parse_eight_digits(uint64_t chunk);
+
+    class _string_view { // Non-owning view into a command line token, a subset of C++17 std::string_view
+        const char *_data = "";
+        size_t _size = 0;
+
+    public:
+        static constexpr size_t npos = (size_t) -1;
+
+        _string_view() = default;
+        _string_view(const char *data, size_t size): _data(data), _size(size) {}
+        _string_view(const char *str): _data(str), _size(strlen(str)) {}
+        _string_view(const std::string &str): _data(str.data()), _size(str.size()) {}
+
+        const char* data() const { return _data; }
+        size_t size() const { return _size; }
+        bool empty() const { return _size == 0; }
+        char operator[](size_t i) const { return _data[i]; }
+
+        _string_view substr(size_t pos, size_t n = npos) const { return {_data + pos, std::min(n, _size - pos)}; }
+        FIRE_API_ size_t find(char c) const;
+        std::string str() const { return std::string(_data, _size); }
+
+        friend bool operator==(const _string_view &a, const _string_view &b)
+            { return a._size == b._size && std::equal(a._data, a._data + a._size, b._data); }
+        friend bool operator!=(const _string_view &a, const _string_view &b) { return ! (a == b); }
+    };
+
+    struct _string_view_hash { // FNV-1a
+        size_t operator()(const _string_view &s) const { return hash(s.data(), s.size()); }
+
+        static FIRE_CONSTEXPR14_ size_t hash(const char *data, size_t size) {
+            size_t hash = 2166136261u;
+            for(size_t i = 0; i < size; ++i)
+                hash = (hash ^ (unsigned char) data[i]) * 16777619u;
+            return hash;
+        }
+    };
+
+    struct _hashed_view { // Names of identifiers are hashed once, not on every lookup
+        _string_view view;
+        size_t hash;
+
+        _hashed_view(const _string_view &view): view(view), hash(_string_view_hash()(view)) {}
+        _hashed_view(const _string_view &view, size_t hash): view(view), hash(hash) {}
+        bool operator==(const _hashed_view &other) const { return hash == other.hash && view == other.view; }
+
+        struct hasher {
+            size_t operator()(const _hashed_view &s) const { return s.hash; }
+        };
+    };
+
+    class _message { // Error message as pieces, concatenated only if an assertion fails. Pieces are views,
+                     // so a message can't outlive the expression creating it
+        struct _piece {
+            _string_view str;
+            long long number;
+            bool is_number;
+        };
+
+        _piece _pieces[6];
+        size_t _count = 0;
+
+        void _add(const _string_view &str) { _pieces[_count++] = {str, 0, false}; }
+        void _add(long long number) { _pieces[_count++] = {_string_view(), number, true}; }
+
+    public:
+        template <typename ... PIECES>
+        _message(const PIECES &... pieces) {
+            static_assert(sizeof...(PIECES) <= 6, "too many message pieces");
+            int expand[] = {0, (_add(pieces), 0)...};
+            (void) expand;
+        }
+
+        FIRE_API_ std::string str() const;
+    };
+
+    FIRE_API_ void _instant_assert(bool pass, const _message &msg, bool programmer_side = true);
+    FIRE_API_ void _exit_program(int code);
+    FIRE_API_ void _write_stderr(const std::string &text); // Writes text to stderr at once
+    FIRE_API_ void _flush_output();
+
+#ifdef FIRE_WRITE_ENABLED_
+    FIRE_API_ bool _write_all(int fd, const void *data, size_t size);
+#endif
+#ifdef FIRE_FORK_SERVER_ENABLED_
+    FIRE_API_ bool _read_all(int fd, void *data, size_t size);
+
+    // Runs a FIRE_FORK_SERVER program listening on socket_path with this process's stdio and working directory.
+    // Returns fired_main's exit code, or -1 if the server can't be reached.
+    FIRE_API_ int fork_client(const char *socket_path, int argc, const char **argv);
+#endif
+    FIRE_API_ int count_hyphens(const _string_view &s);
+    FIRE_API_ const char* _find_char(const char *it, const char *end, char c); // Returns end if c isn't found
+    FIRE_API_ std::string without_hyphens(const std::string &s);
+    FIRE_API_ std::string replace_all(const std::string &data, const std::string &from, const std::string &to);
 
     template <typename T>
     class optional {
@@ -77,15 +315,27 @@ namespace fire {
         explicit operator bool() const { return _exists; }
         bool has_value() const { return _exists; }
         T value_or(const T& def) const { return _exists ? _value : def; }
-        T value() const { _instant_assert(_exists, "accessing unassigned optional"); return _value; }
+        const T& value() const { _instant_assert(_exists, "accessing unassigned optional"); return _value; }
     };
 
     struct _escape_exception {
     };
 
+    struct _exit_exception { // Returns from the running parser (or ends a batch record) instead of exiting
+        int code;
+    };
+
+#ifdef FIRE_STATIC_IDENTIFIERS_ENABLED_
+    struct _static_names { // Names classified and hashed at compile time
+        const char *short_name = nullptr, *long_name = nullptr, *descr = nullptr;
+        size_t short_hash = 0, long_hash = 0;
+    };
+#endif
+
     class identifier {
         optional<int> _pos;
         optional<std::string> _short_name, _long_name, _pos_name, _descr;
+        size_t _short_hash = 0, _long_hash = 0;
         bool _variadic = false;
         bool _optional = false; // Only used for operator<
         bool flag = false; // Only used for operator<
@@ -95,28 +345,36 @@ namespace fire {
     public:
         enum class type { not_specified=-1, positional=0, named=1, flag=2 };
 
-        inline static std::string prepend_hyphens(const std::string &name);
+        FIRE_API_ static std::string prepend_hyphens(const std::string &name);
 
         identifier() = default;
-        inline identifier(const std::vector<std::string> &names, optional<int> pos, bool is_variadic = false);
+        FIRE_API_ identifier(const std::vector<std::string> &names, optional<int> pos, bool is_variadic = false);
+#ifdef FIRE_STATIC_IDENTIFIERS_ENABLED_
+        FIRE_API_ explicit identifier(const _static_names &names);
+#endif
 
         inline void set_as_flag() { flag = true; }
 
-        inline optional<std::string> short_name() const { return _short_name; }
-        inline optional<std::string> long_name() const { return _long_name; }
-
-        inline type get_type() const;
-        inline bool operator<(const identifier &other) const;
-        inline bool overlaps(const identifier &other) const;
-        inline bool contains(const std::string &name) const;
-        inline bool contains(int pos) const;
-        inline std::string help() const { return _help; }
-        inline std::string longer() const { return _longer; }
+        inline const optional<std::string>& short_name() const { return _short_name; }
+        inline const optional<std::string>& long_name() const { return _long_name; }
+        inline size_t short_hash() const { return _short_hash; }
+        inline size_t long_hash() const { return _long_hash; }
+
+        FIRE_API_ type get_type() const;
+        FIRE_API_ bool operator<(const identifier &other) const;
+        FIRE_API_ bool overlaps(const identifier &other) const;
+        FIRE_API_ bool contains(const std::string &name) const;
+        FIRE_API_ bool contains(int pos) const;
+        inline const std::string& help() const { return _help; }
+        inline const std::string& longer() const { return _longer; }
         inline optional<int> get_pos() const { return _pos; }
         inline void set_optional(bool optional) { _optional = optional; }
         inline bool variadic() const { return _variadic; }
 
         inline std::string get_descr() const { return _descr.value_or(""); }
+
+    private:
+        FIRE_API_ void _set_named_help();
     };
 
     template<typename ORDER, typename VALUE>
@@ -131,40 +389,203 @@ namespace fire {
         bool empty() const { return _empty; }
     };
 
+    class _mapped_file { // Private, writable mapping of a file. Changes are never written back to the file
+        char *_data = nullptr;
+        size_t _size = 0;
+        bool _open = false;
+        std::vector<char> _buffer; // Used where memory mapping is unavailable
+
+    public:
+        _mapped_file() = default;
+        FIRE_API_ explicit _mapped_file(const std::string &path);
+        _mapped_file(const _mapped_file &) = delete;
+        _mapped_file& operator=(const _mapped_file &) = delete;
+        inline _mapped_file(_mapped_file &&other) noexcept { *this = std::move(other); }
+        FIRE_API_ _mapped_file& operator=(_mapped_file &&other) noexcept;
+        FIRE_API_ ~_mapped_file();
+
+        bool is_open() const { return _open; }
+        char* data() { return _data; }
+        size_t size() const { return _size; }
+    };
+
+    class _arena { // Bump allocator for per-parse state. Memory is only released by reset() or the destructor
+        struct _block {
+            _block *next;
+            size_t size;
+        };
+
+        char *_user = nullptr; // Optional memory supplied by the user, used before heap blocks
+        size_t _user_size = 0;
+        _block *_blocks = nullptr; // Heap blocks are kept across resets and reused in order
+        _block *_current = nullptr; // Block being allocated from, or nullptr in the user's memory
+        char *_pos = nullptr, *_end = nullptr;
+        size_t _allocated = 0; // Bytes requested since the last reset
+
+        FIRE_API_ void _next_block(size_t size, size_t align);
+
+    public:
+        FIRE_API_ _arena(void *memory = nullptr, size_t size = 0);
+        _arena(const _arena &) = delete;
+        _arena& operator=(const _arena &) = delete;
+        FIRE_API_ ~_arena();
+
+        FIRE_API_ void* allocate(size_t size, size_t align);
+        FIRE_API_ void reset();
+
+        size_t allocated() const { return _allocated; }
+        FIRE_API_ size_t heap_blocks(size_t *bytes = nullptr) const;
+    };
+
+    template <typename T>
+    struct _arena_allocator { // Falls back to the heap without an arena
+        using value_type = T;
+        using propagate_on_container_copy_assignment = std::true_type;
+        using propagate_on_container_move_assignment = std::true_type;
+        using propagate_on_container_swap = std::true_type;
+
+        _arena *arena = nullptr;
+
+        _arena_allocator(_arena *arena = nullptr): arena(arena) {}
+        template <typename U>
+        _arena_allocator(const _arena_allocator<U> &other): arena(other.arena) {}
+
+        T* allocate(size_t n) {
+            return arena ? (T *) arena->allocate(n * sizeof(T), alignof(T)) : std::allocator<T>().allocate(n);
+        }
+        void deallocate(T *p, size_t n) { if(! arena) std::allocator<T>().deallocate(p, n); }
+
+        template <typename U>
+        bool operator==(const _arena_allocator<U> &other) const { return arena == other.arena; }
+        template <typename U>
+        bool operator!=(const _arena_allocator<U> &other) const { return arena != other.arena; }
+    };
+
+    template <typename T>
+    using _arena_vector = std::vector<T, _arena_allocator<T>>;
+
+#ifdef FIRE_STATS
+    class _parse_stats { // Time spent in each phase of parsing, reported as a JSON line after strict validation
+    public:
+        enum phase { none, introspect, parse, convert, check, phase_count };
+
+        class timer { // Attributes time to a phase until destroyed. Phases nested in introspection aren't separated
+            _parse_stats &_stats;
+            phase _previous;
+
+        public:
+            timer(_parse_stats &stats, phase p): _stats(stats), _previous(stats._phase) {
+                if(_previous != introspect) _stats.enter(p);
+            }
+            timer(const timer &) = delete;
+            timer& operator=(const timer &) = delete;
+            ~timer() { if(_previous != introspect) _stats.enter(_previous); }
+        };
+
+    private:
+        std::string _output; // "1" for stderr, otherwise a file appended to. Empty if disabled
+        phase _phase = none;
+        std::chrono::steady_clock::time_point _since;
+        long long _ns[phase_count] = {};
+
+    public:
+        FIRE_API_ _parse_stats();
+
+        bool enabled() const { return ! _output.empty(); }
+        FIRE_API_ void enter(phase p);
+        FIRE_API_ void report(size_t named, size_t positional, size_t options, const _arena *memory);
+    };
+#endif
+
+    struct _token { // Command line token, classified by _matcher::scan()
+        _string_view str;
+        size_t eq = _string_view::npos; // Position of the first '='
+        int hyphens = 0; // Number of leading hyphens
+
+        _token() = default;
+        _token(const _string_view &str, size_t eq, int hyphens): str(str), eq(eq), hyphens(hyphens) {}
+        bool separator() const { return hyphens == 2 && str.size() == 2; } // "--"
+    };
+
+    class _assignment_table { // Names of arguments expecting a value, eg. `-j` for `make -j 8`
+        bool _short[128] = {}; // Single-character ASCII names, indexed by the character after the hyphen
+        std::vector<char> _names; // Other names, viewed by _long
+        std::unordered_set<_hashed_view, _hashed_view::hasher> _long;
+
+    public:
+        _assignment_table() = default;
+        FIRE_API_ explicit _assignment_table(const std::vector<std::string> &names);
+        _assignment_table(const _assignment_table &) = delete;
+        _assignment_table& operator=(const _assignment_table &) = delete;
+        _assignment_table(_assignment_table &&) = default; // Moving _names keeps its buffer
+        _assignment_table& operator=(_assignment_table &&) = default;
+
+        FIRE_API_ bool contains(const _string_view &name) const;
+    };
+
     class _matcher {
-        std::string _executable;
-        std::vector<std::string> _positional;
-        std::vector<std::pair<std::string, optional<std::string>>> _named;
-        std::vector<identifier> _queried;
+        // Per-parse state is allocated from _memory. Unless argv is borrowed, tokens are copied there, as are tokens
+        // rewritten during parsing (eg. `-j 8` -> `-j=8`). Tokens from response files point into their mappings.
+        _arena *_memory = nullptr;
+        std::vector<_mapped_file> _response_files;
+
+        using _views = _arena_vector<_string_view>;
+        using _tokens = _arena_vector<_token>;
+        using _name_index = std::unordered_map<_hashed_view, size_t, _hashed_view::hasher, std::equal_to<_hashed_view>,
+                                               _arena_allocator<std::pair<const _hashed_view, size_t>>>;
+        using _name_set = std::unordered_set<_hashed_view, _hashed_view::hasher, std::equal_to<_hashed_view>,
+                                             _arena_allocator<_hashed_view>>;
+
+        _string_view _executable;
+        _views _positional;
+        _arena_vector<std::pair<_string_view, optional<_string_view>>> _named;
+        _name_index _named_index; // Name -> first occurrence in _named
+        _name_set _queried_names; // Only filled in strict mode
+        _arena_vector<bool> _named_queried; // Tokens of _named consumed by a query
+        _arena_vector<bool> _positional_queried; // Queried positions, may exceed _positional. Only filled in strict mode
+        size_t _queried_positional_prefix = 0; // Positions [0, prefix) queried at once by a variadic argument
         _first<identifier, std::string> _deferred_error;
         int _main_args = 0;
         bool _introspect = false;
         bool _strict = false;
         bool _help_flag = false;
+        bool _checked = false; // Every argument of fired_main is converted and valid, its body runs
+        std::unique_ptr<_arena> _own_memory; // Used unless the caller supplies an arena. Assigned after the containers
 
     public:
         enum class arg_type { string_t, bool_t, none_t };
 
         inline _matcher() = default;
-        inline _matcher(int argc, const char **argv, int main_args, bool strict);
-
-        inline void check(bool dec_main_args);
-        inline void check_named();
-        inline void check_positional();
-
-        inline std::pair<std::string, arg_type> get_and_mark_as_queried(const identifier &id);
-        inline void parse(int argc, const char **argv);
-        inline std::vector<std::string> to_vector_string(int n_strings, const char **strings);
-        inline std::vector<std::string> equate_assignments(
-                const std::vector<std::string> &raw, const std::vector<std::string> &assigned);
-        inline std::tuple<std::vector<std::string>, std::vector<std::string>>
-                separate_named_positional(const std::vector<std::string> &eqs);
-        inline std::vector<std::string> expand_single_hyphen(const std::vector<std::string> &named);
-        inline std::vector<std::pair<std::string, optional<std::string>>>
-                assign_named_values(const std::vector<std::string> &split);
-        inline const std::string& get_executable() { return _executable; }
+        FIRE_API_ _matcher(int argc, const char **argv, int main_args, bool strict, bool borrow_argv = false,
+                        _arena *memory = nullptr);
+        FIRE_API_ static bool needs_introspection(int argc, const char **argv);
+        _matcher(const _matcher &) = delete; // Views would point to the original's buffers
+        _matcher& operator=(const _matcher &) = delete;
+        _matcher(_matcher &&) = default;
+        _matcher& operator=(_matcher &&) = default;
+        FIRE_API_ ~_matcher();
+
+        FIRE_API_ void check(bool dec_main_args);
+        inline bool checked() const { return _checked; }
+        FIRE_API_ void check_named();
+        FIRE_API_ void check_positional();
+
+        FIRE_API_ std::pair<_string_view, arg_type> get_and_mark_as_queried(const identifier &id);
+        FIRE_API_ const _arena_vector<_string_view>& get_and_mark_all_positional_as_queried();
+        FIRE_API_ void parse(int argc, const char **argv, bool borrow_argv);
+        FIRE_API_ _views to_views(int n_strings, const char **strings, bool borrow);
+        FIRE_API_ _views expand_response_files(const _views &raw);
+        FIRE_API_ static void tokenize_response_file(char *data, size_t size, _views &tokens);
+        FIRE_API_ _tokens scan(const _views &raw);
+        FIRE_API_ _string_view store(const char *data, size_t size);
+        FIRE_API_ _token materialize(const _string_view &name, const _string_view &value);
+        FIRE_API_ _tokens equate_assignments(const _tokens &raw, const _assignment_table &assigned);
+        FIRE_API_ std::tuple<_tokens, _views> separate_named_positional(const _tokens &eqs);
+        FIRE_API_ _tokens expand_single_hyphen(const _tokens &named);
+        FIRE_API_ _arena_vector<std::pair<_string_view, optional<_string_view>>> assign_named_values(const _tokens &split);
+        inline std::string get_executable() const { return _executable.str(); }
         inline size_t pos_args() { return _positional.size(); }
-        inline bool deferred_assert(const identifier &id, bool pass, const std::string &msg);
+        FIRE_API_ bool deferred_assert(const identifier &id, bool pass, const _message &msg);
 
         inline void set_introspect(bool introspect) { _introspect = introspect; }
         inline bool get_introspect() const { return _introspect; }
@@ -184,39 +605,172 @@ namespace fire {
 
     private:
         std::string _program_descr;
-        std::vector<std::pair<identifier, elem>> _params;
+        _arena_vector<std::pair<identifier, elem>> _params;
         int _introspect_count = 0;
 
-        inline std::string _make_printable(const identifier &id, const elem &elem, bool verbose);
-        inline void _add_to_help(std::string &usage, std::string &options,
+        FIRE_API_ std::string _make_printable(const identifier &id, const elem &elem, bool verbose);
+        FIRE_API_ void _add_to_help(std::string &usage, std::string &options,
                                  const identifier &id, const elem &elem, size_t margin);
     public:
-        inline void print_help();
-        inline std::vector<std::string> get_assignment_arguments() const;
-        inline void log(const identifier &name, const elem &elem);
-        inline void set_introspect_count(int count);
+        explicit _arg_logger(_arena *memory = nullptr): _params(memory) {}
+
+        FIRE_API_ void print_help();
+        FIRE_API_ std::vector<std::string> get_assignment_arguments() const;
+        FIRE_API_ void log(const identifier &name, const elem &elem);
+        FIRE_API_ void set_introspect_count(int count);
         inline void set_program_descr(const std::string &program_descr) { _program_descr = program_descr; }
-        inline int decrease_introspect_count();
+        FIRE_API_ int decrease_introspect_count();
         inline int get_introspect_count() const { return _introspect_count; }
+        inline size_t size() const { return _params.size(); }
+    };
+
+    class parser { // Parses a command line for fire::arg objects created by the same thread while run() executes
+        int _argc;
+        const char **_argv;
+        _arena _memory; // Per-parse state of _match, reset before every parse
+        _matcher _match;
+        _arg_logger _log;
+        int _main_args = 0;
+        std::string _program_descr;
+        int (*_call)() = nullptr;
+        _assignment_table _assigned; // Arguments expecting a value, found by introspection
+        bool _response_files = false;
+        bool _integer_literals = false;
+#ifdef FIRE_STATS
+        _parse_stats _stats;
+#endif
+
+        enum class _run_mode { single, batch, server };
+        _run_mode _mode = _run_mode::single;
+
+        // Batch mode, records are read into _input and arguments of the current record are in _record_argv
+        bool _in_record = false;
+        std::FILE *_records = nullptr, *_codes = nullptr;
+        std::vector<char> _input;
+        size_t _record_begin = 0;
+        std::vector<size_t> _record_offsets;
+        std::vector<const char *> _record_argv;
+
+        template <typename T_VOID>
+        friend struct _storage;
+
+        FIRE_API_ void _start(int main_args, const std::string &program_descr, int (*call)());
+        FIRE_API_ void _introspect();
+        FIRE_API_ void _parse(int argc, const char **argv);
+        FIRE_API_ int _run_records();
+        FIRE_API_ bool _read_record();
+#ifdef FIRE_FORK_SERVER_ENABLED_
+        FIRE_API_ int _serve();
+        FIRE_API_ int _handle_connection(int conn);
+#endif
+
+    public:
+        // If memory is given, parsing allocates from it until it's exhausted, and only then from the heap
+        inline parser(int argc = 0, const char **argv = nullptr, void *memory = nullptr, size_t memory_size = 0):
+            _argc(argc), _argv(argv), _memory(memory, memory_size) {}
+        parser(const parser &) = delete;
+        parser& operator=(const parser &) = delete;
+
+        // Use FIRE_RUN(parser, fired_main[, program_descr]), FIRE_BATCH(...) and FIRE_FORK_SERVER(...) instead,
+        // which preserve fired_main's default arguments
+        FIRE_API_ int run(int main_args, const std::string &program_descr, int (*call)());
+        FIRE_API_ int run_batch(int main_args, const std::string &program_descr, int (*call)());
+#ifdef FIRE_FORK_SERVER_ENABLED_
+        FIRE_API_ int run_server(int main_args, const std::string &program_descr, int (*call)());
+#endif
+        FIRE_API_ int _run_parsed();
+
+        // `@path` arguments are replaced by the contents of file path. Off by default, as it changes the meaning of
+        // values starting with `@`
+        void set_response_files(bool enabled) { _response_files = enabled; }
+        bool response_files() const { return _response_files; }
+        // Integers may also have `0x`, `0o` and `0b` prefixes and `_` digit separators. Off by default, as it
+        // accepts command lines that used to be invalid
+        void set_integer_literals(bool enabled) { _integer_literals = enabled; }
+        bool integer_literals() const { return _integer_literals; }
+
+        bool in_record() const { return _in_record; }
+        const _assignment_table& assignment_arguments() const { return _assigned; }
     };
 
     template <typename T_VOID = void>
     struct _storage {
-        static _matcher matcher;
-        static _arg_logger logger;
+        static thread_local parser *current; // Parser running on this thread, if any
+
+        inline static parser& active();
+        static _matcher& matcher() { return active()._match; }
+        static _arg_logger& logger() { return active()._log; }
+#ifdef FIRE_STATS
+        static _parse_stats& stats() { return active()._stats; }
+#endif
     };
 
     template <typename T_VOID>
-    _matcher _storage<T_VOID>::matcher;
+    thread_local parser *_storage<T_VOID>::current = nullptr;
 
     template <typename T_VOID>
-    _arg_logger _storage<T_VOID>::logger;
+    parser& _storage<T_VOID>::active() {
+        static thread_local parser fallback; // Used when fire::arg is converted outside of parser::run()
+        return current ? *current : fallback;
+    }
 
     using _ = _storage<void>;
 
     struct variadic {
     };
 
+    template <typename T, bool prevalidate = false>
+    class arg_range;
+
+#ifdef FIRE_STATIC_IDENTIFIERS_ENABLED_
+    template <size_t N>
+    struct _fixed_string { // String literal usable as a template argument
+        char data[N] = {};
+
+        constexpr _fixed_string(const char (&str)[N]) { std::copy_n(str, N, data); }
+        constexpr size_t size() const { return N - 1; }
+        constexpr size_t hyphens() const { size_t h = 0; while(h < size() && data[h] == '-') ++h; return h; }
+        constexpr bool is_pos_name() const { return size() >= 2 && data[0] == '<' && data[size() - 1] == '>'; }
+    };
+
+    template <_fixed_string... names>
+    class _static_identifier { // Same rules as identifier, checked during compilation
+        static constexpr size_t _count(size_t hyphens) { return ((names.hyphens() == hyphens) + ... + 0); }
+
+        static_assert(((names.hyphens() <= 2) && ...), "Identifier entries must prefix either:"
+                      " 0 hyphens for description, 1 hyphen for short-hand name, 2 hyphens for long name");
+        static_assert(_count(0) <= 1, "Can't specify descriptions twice");
+        static_assert(_count(1) <= 1, "Can't specify shorthands twice");
+        static_assert(_count(2) <= 1, "Can't specify long names twice");
+        static_assert(((names.hyphens() != 1 || names.size() == 2) && ...),
+                      "Single hyphen shorthand must be one character");
+        static_assert(((names.hyphens() != 1 || names.size() < 2 || names.data[1] < '0' || names.data[1] > '9') && ...),
+                      "Arguments can't start with a number");
+        static_assert(((names.hyphens() != 2 || names.size() >= 4) && ...),
+                      "Two hyphen names must have at least two characters");
+        static_assert(_count(1) + _count(2) >= 1, "Argument must be specified with a shorthand or a long name");
+        static_assert(! (names.is_pos_name() || ...), "Positional names require the argument to be positional");
+
+        static constexpr _static_names _classify() {
+            _static_names ret;
+            auto add = [&ret](const char *data, size_t size, size_t hyphens) {
+                size_t hash = _string_view_hash::hash(data, size);
+                if(hyphens == 0) ret.descr = data;
+                if(hyphens == 1) { ret.short_name = data; ret.short_hash = hash; }
+                if(hyphens == 2) { ret.long_name = data; ret.long_hash = hash; }
+            };
+            (add(names.data, names.size(), names.hyphens()), ...);
+            return ret;
+        }
+
+    public:
+        static constexpr _static_names value = _classify();
+    };
+
+    template <_fixed_string... names> // Eg. fire::arg(fire::id<"-t", "--threads", "Thread count">, 4)
+    inline constexpr _static_identifier<names...> id{};
+#endif
+
     class arg {
         identifier _id; // No identifier implies vector positional arguments
 
@@ -224,19 +778,63 @@ namespace fire {
         optional<long double> _float_value;
         optional<std::string> _string_value;
 
+        enum class _status { valid, not_integer, not_real, not_positive, out_of_range };
+
+        // Conversions from command line strings, independent of matcher state. literals enables the syntax of
+        // parser::set_integer_literals(), it's passed explicitly as conversions may run on other threads
+        template <typename T, typename std::enable_if<_is_integer<T>::value>::type* = nullptr>
+        static _status _parse(const _string_view &str, T &value, bool literals);
+        template <typename T, typename std::enable_if<std::is_floating_point<T>::value>::type* = nullptr>
+        static _status _parse(const _string_view &str, T &value, bool literals);
+        static _status _parse(const _string_view &str, std::string &value, bool) {
+            value = str.str();
+            return _status::valid;
+        }
+
+        template <typename U>
+        static bool _parse_magnitude(const char *it, const char *end, int shift, bool separators, U &magnitude,
+                                     bool &overflow);
+        template <typename T>
+        static bool _parse_fast(uint64_t mantissa, long long exponent, T &value);
+        FIRE_API_ static std::string _error_message(_status status, const identifier &id, const std::string &value);
+
+        // Both return the position of the first invalid value (and its status), or n if all are valid
+        template <typename T>
+        static size_t _parse_all(const _string_view *str, size_t n, T *values, bool literals, _status &status);
         template <typename T>
-        optional<T> _get() { T::unimplemented_function; } // no default function
+        static size_t _parse_all_serial(const _string_view *str, size_t n, T *values, bool literals,
+                                        _status &status);
+
+        // Single values of every type are converted by a non-template core, which only needs the type's description
+        struct _type {
+            _arg_logger::elem::type kind; // integer, real or string
+            size_t size;
+            bool is_signed;
+            // Integers up to 64 bits are parsed to (unsigned) long long
+            _status (*parse)(const _string_view &str, void *value, bool literals);
+        };
 
-        template <typename T, typename std::enable_if<std::is_integral<T>::value && ! std::is_same<T, bool>::value>::type* = nullptr>
-        optional<T> _get_with_precision();
+        template <typename T>
+        static _status _parse_erased(const _string_view &str, void *value, bool literals) {
+            return _parse(str, *(T *) value, literals);
+        }
+        template <typename T, typename std::enable_if<_is_integer<T>::value>::type* = nullptr>
+        static _type _describe();
         template <typename T, typename std::enable_if<std::is_floating_point<T>::value>::type* = nullptr>
-        optional<T> _get_with_precision();
-        template <typename T, typename std::enable_if<std::is_same<T, bool>::value || std::is_same<T, std::string>::value, bool>::type* = nullptr>
-        optional<T> _get_with_precision() { return _get<T>(); }
+        static _type _describe() { return {_arg_logger::elem::type::real, sizeof(T), true, _parse_erased<T>}; }
+        template <typename T, typename std::enable_if<std::is_same<T, std::string>::value>::type* = nullptr>
+        static _type _describe() { return {_arg_logger::elem::type::string, sizeof(T), false, _parse_erased<T>}; }
+
+        FIRE_API_ static _status _parse_value(const _type &type, const _string_view &str, void *value,
+                                              bool literals);
+        FIRE_API_ static _status _store_integer(const _type &type, bool negative, unsigned long long magnitude,
+                                                void *value);
+        FIRE_API_ bool _default_value(const _type &type, void *value);
+        FIRE_API_ bool _convert_value(const _type &type, void *value, bool optional, bool dec_main_args);
 
         template <typename T> optional<T> _convert_optional(bool dec_main_args=true);
         template <typename T> T _convert(bool dec_main_args=true);
-        inline void _log(_arg_logger::elem::type t, bool optional);
+        FIRE_API_ void _log(_arg_logger::elem::type t, bool optional);
 
         template <typename T, typename std::enable_if<std::is_integral<T>::value>::type* = nullptr>
         inline void init_default(T value) { _int_value = value; }
@@ -280,44 +878,552 @@ namespace fire {
         inline arg(convertible _id, T value=T()):
             arg({_id}, value) {}
 
-        template <typename T, typename std::enable_if<std::is_integral<T>::value>::type* = nullptr>
+#ifdef FIRE_STATIC_IDENTIFIERS_ENABLED_
+        template<_fixed_string... names, typename T=std::nullptr_t> requires (sizeof...(names) > 0)
+        inline arg(_static_identifier<names...>, T value=T()):
+            _id(_static_identifier<names...>::value) { init_default(value); }
+#endif
+
+        template <typename T, typename std::enable_if<_is_integer<T>::value>::type* = nullptr>
         inline operator optional<T>() { _log(_arg_logger::elem::type::integer, true); return _convert_optional<T>(); }
         template <typename T, typename std::enable_if<std::is_floating_point<T>::value>::type* = nullptr>
         inline operator optional<T>() { _log(_arg_logger::elem::type::real, true); return _convert_optional<T>(); }
         inline operator optional<std::string>() { _log(_arg_logger::elem::type::string, true); return _convert_optional<std::string>(); }
 
-        template <typename T, typename std::enable_if<std::is_integral<T>::value>::type* = nullptr>
+        template <typename T, typename std::enable_if<_is_integer<T>::value>::type* = nullptr>
         inline operator T() { _log(_arg_logger::elem::type::integer, false); return _convert<T>(); }
         template <typename T, typename std::enable_if<std::is_floating_point<T>::value>::type* = nullptr>
         inline operator T() { _log(_arg_logger::elem::type::real, false); return _convert<T>(); }
         inline operator std::string() { _log(_arg_logger::elem::type::string, false); return _convert<std::string>(); }
-        inline operator bool();
+        FIRE_API_ operator bool();
 
         template <typename T>
         inline operator std::vector<T>();
+        template <typename T, bool prevalidate>
+        inline operator arg_range<T, prevalidate>();
+
+        template <typename T, bool prevalidate>
+        friend class arg_range;
+    };
+
+    template <typename T, bool prevalidate>
+    class arg_range { // Positional arguments, converted only when accessed
+        const _string_view *_begin = nullptr, *_end = nullptr;
+
+        inline static T _convert(const _string_view *it, size_t pos);
+
+    public:
+        class iterator {
+            const _string_view *_it = nullptr;
+            size_t _pos = 0;
+
+        public:
+            using iterator_category = std::input_iterator_tag;
+            using value_type = T;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const T*;
+            using reference = T;
+
+            iterator() = default;
+            iterator(const _string_view *it, size_t pos): _it(it), _pos(pos) {}
+
+            T operator*() const { return _convert(_it, _pos); }
+            iterator& operator++() { ++_it; ++_pos; return *this; }
+            iterator operator++(int) { iterator old = *this; ++*this; return old; }
+            bool operator==(const iterator &other) const { return _it == other._it; }
+            bool operator!=(const iterator &other) const { return _it != other._it; }
+        };
+
+        arg_range() = default;
+        arg_range(const _string_view *begin, const _string_view *end): _begin(begin), _end(end) {}
+
+        iterator begin() const { return iterator(_begin, 0); }
+        iterator end() const { return iterator(_end, size()); }
+        size_t size() const { return (size_t) (_end - _begin); }
+        bool empty() const { return _begin == _end; }
+        T operator[](size_t pos) const { return _convert(_begin + pos, pos); }
+    };
+
+#ifdef FIRE_DEFINITIONS_ENABLED_ // Non-template definitions
+    struct _restore_current { // Also restores if fired_main throws
+        parser *previous;
+        ~_restore_current() { _::current = previous; }
     };
 
-    void _instant_assert(bool pass, const std::string &msg, bool programmer_side) {
+    int parser::run(int main_args, const std::string &program_descr, int (*call)()) {
+        _restore_current restore{_::current};
+        _::current = this;
+
+#ifdef FIRE_EXCEPTIONS_ENABLED_
+        try {
+#endif
+            _start(main_args, program_descr, call);
+            if(main_args > 0 && _matcher::needs_introspection(_argc, _argv))
+                _introspect();
+            return _run_parsed();
+#ifdef FIRE_EXCEPTIONS_ENABLED_
+        } catch (const _exit_exception &e) {
+            return e.code;
+        }
+#endif
+    }
+
+    int parser::run_batch(int main_args, const std::string &program_descr, int (*call)()) {
+        // Usage: program [records [codes]], where records default to stdin and exit codes to stderr
+        _restore_current restore{_::current};
+        _::current = this;
+
+        bool records_path = _argc >= 2 && std::string(_argv[1]) != "-", codes_path = _argc >= 3;
+#ifdef FIRE_EXCEPTIONS_ENABLED_
+        try {
+#endif
+            _start(main_args, program_descr, call);
+            if(_argc == 2 && (std::string(_argv[1]) == "-h" || std::string(_argv[1]) == "--help")) {
+                if(main_args > 0) // Help describes the arguments of a record
+                    _introspect();
+                return _run_parsed();
+            }
+
+            _mode = _run_mode::batch;
+            _instant_assert(_argc <= 3, _message("usage: ", _argc > 0 ? _argv[0] : "program", " [records [codes]]"),
+                            false);
+            _records = records_path ? fopen(_argv[1], "rb") : stdin;
+            _instant_assert(_records, _message("can't open ", records_path ? _argv[1] : "", " for reading"), false);
+            _codes = codes_path ? fopen(_argv[2], "w") : stderr;
+            _instant_assert(_codes, _message("can't open ", codes_path ? _argv[2] : "", " for writing"), false);
+
+            // Schema is the same for every record, so introspection is done once. Without exceptions, it
+            // continues in _run_parsed(), so the mode and files must be set up before
+            if(main_args > 0)
+                _introspect();
+            int ret = _run_parsed();
+
+            if(records_path) fclose(_records);
+            if(codes_path) fclose(_codes);
+            return ret;
+#ifdef FIRE_EXCEPTIONS_ENABLED_
+        } catch (const _exit_exception &e) {
+            if(records_path && _records) fclose(_records);
+            if(codes_path && _codes) fclose(_codes);
+            return e.code;
+        }
+#endif
+    }
+
+    void parser::_start(int main_args, const std::string &program_descr, int (*call)()) {
+        _main_args = main_args;
+        _program_descr = program_descr;
+        _call = call;
+        _log = _arg_logger();
+        _match = _matcher();
+    }
+
+    void parser::_introspect() {
+        FIRE_STATS_PHASE_(introspect);
+        _log.set_introspect_count(_main_args);
+#ifdef FIRE_EXCEPTIONS_ENABLED_
+        try {
+            _call(); // function isn't actually executed, the last default argument will always throw
+        } catch (_escape_exception) {
+        }
+#else
+        _call(); // never returns, the last default argument calls _run_parsed() and exits
+#endif
+    }
+
+    int parser::_run_parsed() {
+        _assigned = _assignment_table(_log.get_assignment_arguments());
+        if(_mode == _run_mode::batch)
+            return _run_records();
+#ifdef FIRE_FORK_SERVER_ENABLED_
+        if(_mode == _run_mode::server)
+            return _serve();
+#endif
+
+        _parse(_argc, _argv);
+        return _call();
+    }
+
+    void parser::_parse(int argc, const char **argv) {
+        FIRE_STATS_PHASE_(parse);
+        // Everything pointing into the arena is dropped before it's reused
+        _match = _matcher();
+        _log = _arg_logger();
+        _memory.reset();
+
+        _log = _arg_logger(&_memory);
+        _log.set_program_descr(_program_descr);
+        _match = _matcher(argc, argv, _main_args, true, true, &_memory);
+    }
+
+    int parser::_run_records() {
+        int ret = 0;
+        while(_read_record()) {
+            int code;
+            _in_record = true;
+#ifdef FIRE_EXCEPTIONS_ENABLED_
+            try {
+#endif
+                _parse((int) _record_argv.size(), _record_argv.data());
+                code = _call();
+#ifdef FIRE_EXCEPTIONS_ENABLED_
+            } catch (const _exit_exception &e) {
+                code = e.code;
+            }
+#endif
+            _in_record = false;
+            _flush_output();
+            fprintf(_codes, "%d\n", code);
+            fflush(_codes);
+            if(code != 0)
+                ret = _failure_code;
+        }
+        return ret;
+    }
+
+    bool parser::_read_record() {
+        // A record is a sequence of null-terminated arguments, followed by an empty argument
+        const size_t chunk = 1 << 16;
+        size_t pos = _record_begin;
+        _record_offsets.clear();
+        while(true) {
+            const char *nul = pos < _input.size() ?
+                    (const char *) memchr(_input.data() + pos, '\0', _input.size() - pos) : nullptr;
+            if(nul) {
+                size_t nul_pos = (size_t) (nul - _input.data());
+                if(nul_pos == pos) // Empty argument ends the record
+                    break;
+                _record_offsets.push_back(pos);
+                pos = nul_pos + 1;
+                continue;
+            }
+
+            // Discard consumed records and read more, offsets of the current record move along
+            _input.erase(_input.begin(), _input.begin() + _record_begin);
+            pos -= _record_begin;
+            for(size_t &offset: _record_offsets)
+                offset -= _record_begin;
+            _record_begin = 0;
+
+            size_t size = _input.size();
+            _input.resize(size + chunk);
+            _input.resize(size + fread(_input.data() + size, 1, chunk, _records));
+            if(_input.size() == size) { // End of input, an unterminated last record is accepted
+                if(pos < size) {
+                    _input.push_back('\0');
+                    _record_offsets.push_back(pos);
+                    pos = _input.size();
+                }
+                if(_record_offsets.empty())
+                    return false;
+                _input.push_back('\0');
+                break;
+            }
+        }
+
+        _record_begin = pos + 1;
+        _record_argv.assign(1, _argc > 0 ? _argv[0] : "");
+        for(size_t offset: _record_offsets)
+            _record_argv.push_back(_input.data() + offset);
+        return true;
+    }
+
+#ifdef FIRE_FORK_SERVER_ENABLED_
+    int parser::run_server(int main_args, const std::string &program_descr, int (*call)()) {
+        // `program --fire-server=SOCKET` serves fire::fork_client(), other command lines are run directly
+        if(_argc != 2 || std::string(_argv[1]).compare(0, 14, "--fire-server=") != 0)
+            return run(main_args, program_descr, call);
+
+        _restore_current restore{_::current};
+        _::current = this;
+
+#ifdef FIRE_EXCEPTIONS_ENABLED_
+        try { // Also catches errors of forked workers, which then return from here
+#endif
+            _start(main_args, program_descr, call);
+            _mode = _run_mode::server;
+            if(main_args > 0) // Children inherit the schema, so they never introspect
+                _introspect();
+            return _run_parsed();
+#ifdef FIRE_EXCEPTIONS_ENABLED_
+        } catch (const _exit_exception &e) {
+            return e.code;
+        }
+#endif
+    }
+
+    int parser::_serve() {
+        std::string path = std::string(_argv[1]).substr(14);
+        sockaddr_un address = sockaddr_un();
+        address.sun_family = AF_UNIX;
+        _instant_assert(path.size() < sizeof(address.sun_path), _message("socket path ", path, " is too long"), false);
+        memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+        struct stat existing;
+        if(lstat(path.c_str(), &existing) == 0) { // Only a socket left by an earlier server is replaced
+            _instant_assert(S_ISSOCK(existing.st_mode), _message(path, " exists and isn't a socket"), false);
+            unlink(path.c_str());
+        }
+        int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+        _instant_assert(listener >= 0 && bind(listener, (sockaddr *) &address, sizeof(address)) == 0
+                        && listen(listener, SOMAXCONN) == 0, _message("can't listen on ", path), false);
+        signal(SIGCHLD, SIG_IGN); // Connection handlers are reaped automatically
+
+        while(true) {
+            int conn = accept(listener, nullptr, nullptr);
+            if(conn < 0)
+                continue;
+
+            _flush_output();
+            if(fork() == 0) {
+                close(listener);
+                signal(SIGCHLD, SIG_DFL);
+                _exit(_handle_connection(conn));
+            }
+            close(conn);
+        }
+    }
+
+    int parser::_handle_connection(int conn) {
+        // The client sends stdin, stdout and stderr with the payload size, followed by the payload:
+        // working directory and arguments, each null-terminated. The exit code of fired_main is sent back.
+#ifdef SO_PEERCRED // Only the server's user may run it
+        ucred peer;
+        socklen_t peer_size = sizeof(peer);
+        if(getsockopt(conn, SOL_SOCKET, SO_PEERCRED, &peer, &peer_size) != 0 || peer.uid != geteuid())
+            return _failure_code;
+#elif defined(__APPLE__)
+        uid_t peer_uid;
+        gid_t peer_gid;
+        if(getpeereid(conn, &peer_uid, &peer_gid) != 0 || peer_uid != geteuid())
+            return _failure_code;
+#endif
+        uint64_t size = 0;
+        int fds[3];
+        char control[CMSG_SPACE(sizeof(fds))];
+        iovec data = {&size, sizeof(size)};
+        msghdr message = msghdr();
+        message.msg_iov = &data;
+        message.msg_iovlen = 1;
+        message.msg_control = control;
+        message.msg_controllen = sizeof(control);
+        if(recvmsg(conn, &message, 0) != (ssize_t) sizeof(size))
+            return _failure_code;
+        cmsghdr *header = CMSG_FIRSTHDR(&message);
+        if(! header || header->cmsg_level != SOL_SOCKET || header->cmsg_type != SCM_RIGHTS
+                || header->cmsg_len != CMSG_LEN(sizeof(fds)))
+            return _failure_code;
+        memcpy(fds, CMSG_DATA(header), sizeof(fds));
+
+        // Arguments of the client fit in ARG_MAX and so does its working directory
+        long arg_max = sysconf(_SC_ARG_MAX);
+        if(size > 2 * (uint64_t) (arg_max > 0 ? arg_max : 1 << 20))
+            return _failure_code;
+        std::vector<char> payload(size + 1);
+        if(! _read_all(conn, payload.data(), size))
+            return _failure_code;
+        std::vector<const char *> args = {_argv[0]};
+        const char *cwd = payload.data();
+        for(size_t i = strlen(cwd) + 1; i < size; i += strlen(payload.data() + i) + 1)
+            args.push_back(payload.data() + i);
+
+        pid_t worker = fork();
+        if(worker == 0) {
+            close(conn);
+            for(int fd = 0; fd < 3; ++fd) {
+                dup2(fds[fd], fd);
+                close(fds[fd]);
+            }
+            _instant_assert(chdir(cwd) == 0, _message("can't change directory to ", cwd), false);
+
+            _mode = _run_mode::single;
+            _argc = (int) args.size();
+            _argv = args.data();
+            exit(_run_parsed());
+        }
+        for(int fd: fds)
+            close(fd);
+
+        int status = 0;
+        if(worker < 0 || waitpid(worker, &status, 0) != worker)
+            return _failure_code;
+        int32_t code = WIFEXITED(status) ? WEXITSTATUS(status) : 128 + WTERMSIG(status);
+        return _write_all(conn, &code, sizeof(code)) ? 0 : _failure_code;
+    }
+
+    bool _read_all(int fd, void *data, size_t size) {
+        for(size_t done = 0; done < size; ) {
+            ssize_t n = read(fd, (char *) data + done, size - done);
+            if(n <= 0)
+                return false;
+            done += (size_t) n;
+        }
+        return true;
+    }
+
+    int fork_client(const char *socket_path, int argc, const char **argv) {
+        sockaddr_un address = sockaddr_un();
+        address.sun_family = AF_UNIX;
+        if(strlen(socket_path) >= sizeof(address.sun_path))
+            return -1;
+        memcpy(address.sun_path, socket_path, strlen(socket_path) + 1);
+
+        int conn = socket(AF_UNIX, SOCK_STREAM, 0);
+        if(conn < 0)
+            return -1;
+        if(connect(conn, (sockaddr *) &address, sizeof(address)) != 0) {
+            close(conn);
+            return -1;
+        }
+
+        std::vector<char> cwd(256);
+        while(! getcwd(cwd.data(), cwd.size()) && errno == ERANGE)
+            cwd.resize(cwd.size() * 2);
+        std::string payload(cwd.data());
+        payload.push_back('\0');
+        for(int i = 1; i < argc; ++i)
+            payload.append(argv[i], strlen(argv[i]) + 1);
+
+        uint64_t size = payload.size();
+        int fds[3] = {0, 1, 2};
+        char control[CMSG_SPACE(sizeof(fds))];
+        memset(control, 0, sizeof(control));
+        iovec data = {&size, sizeof(size)};
+        msghdr message = msghdr();
+        message.msg_iov = &data;
+        message.msg_iovlen = 1;
+        message.msg_control = control;
+        message.msg_controllen = sizeof(control);
+        cmsghdr *header = CMSG_FIRSTHDR(&message);
+        header->cmsg_level = SOL_SOCKET;
+        header->cmsg_type = SCM_RIGHTS;
+        header->cmsg_len = CMSG_LEN(sizeof(fds));
+        memcpy(CMSG_DATA(header), fds, sizeof(fds));
+
+        int32_t code = -1;
+        if(sendmsg(conn, &message, 0) != (ssize_t) sizeof(size) || ! _write_all(conn, payload.data(), payload.size())
+                || ! _read_all(conn, &code, sizeof(code)))
+            code = -1;
+        close(conn);
+        return code;
+    }
+#endif
+
+    void _exit_program(int code) {
+#ifdef FIRE_EXCEPTIONS_ENABLED_
+        // Until fired_main's arguments are checked, parser::run() and friends catch this, so a host of FIRE_RUN
+        // keeps running. Later errors (eg. of arg_range) come from fired_main's body, which could swallow them.
+        if(_::active().in_record() || (_::current && ! _::matcher().checked()))
+            throw _exit_exception{code};
+#endif
+        exit(code);
+    }
+
+#ifdef FIRE_WRITE_ENABLED_
+    bool _write_all(int fd, const void *data, size_t size) {
+        for(size_t done = 0; done < size; ) {
+            ssize_t n = write(fd, (const char *) data + done, size - done);
+            if(n < 0 && errno == EINTR)
+                continue;
+            if(n <= 0)
+                return false;
+            done += (size_t) n;
+        }
+        return true;
+    }
+#endif
+
+    void _write_stderr(const std::string &text) {
+        _flush_output(); // Earlier output stays in order
+#ifdef FIRE_WRITE_ENABLED_
+        _write_all(2, text.data(), text.size());
+#else
+        fwrite(text.data(), 1, text.size(), stderr);
+        fflush(stderr);
+#endif
+    }
+
+    void _flush_output() {
+#ifndef FIRE_NO_IOSTREAM
+        std::cout.flush();
+        std::cerr.flush();
+#endif
+        fflush(stdout);
+        fflush(stderr);
+    }
+
+    std::string _message::str() const {
+        std::string str;
+        for(size_t i = 0; i < _count; ++i)
+            if(_pieces[i].is_number)
+                str += std::to_string(_pieces[i].number);
+            else
+                str.append(_pieces[i].str.data(), _pieces[i].str.size());
+        return str;
+    }
+
+    void _instant_assert(bool pass, const _message &msg, bool programmer_side) {
         if (pass)
             return;
 
-        if (!msg.empty()) {
-            std::cerr << "Error";
-            if(programmer_side)
-                std::cerr << " (programmer side)";
-            std::cerr << ": " << msg << std::endl;
-        }
+        std::string str = msg.str();
+        if (!str.empty())
+            _write_stderr(std::string("Error") + (programmer_side ? " (programmer side)" : "") + ": " + str + "\n");
+
+        _exit_program(_failure_code);
+    }
 
-        exit(_failure_code);
+    size_t _string_view::find(char c) const {
+        const void *found = memchr(_data, c, _size);
+        return found ? (size_t) ((const char *) found - _data) : npos;
     }
 
-    int count_hyphens(const std::string &s) {
+    inline _string_view _single_hyphen_name(char c) { // Views to "-a", "-b", ... without allocating
+        struct table {
+            char names[256][3];
+            table() {
+                for(int i = 0; i < 256; ++i) {
+                    names[i][0] = '-';
+                    names[i][1] = (char) i;
+                    names[i][2] = '\0';
+                }
+            }
+        };
+        static const table names;
+        return _string_view(names.names[(unsigned char) c], 2);
+    }
+
+    int count_hyphens(const _string_view &s) {
         int hyphens;
         for(hyphens = 0; hyphens < (int) s.size() && s[hyphens] == '-'; ++hyphens)
             ;
         return hyphens;
     }
 
+    const char* _find_char(const char *it, const char *end, char c) {
+#if defined(FIRE_AVX2_ENABLED_)
+        const __m256i needle = _mm256_set1_epi8(c);
+        for(; end - it >= 32; it += 32) {
+            __m256i chunk = _mm256_loadu_si256((const __m256i *) it);
+            unsigned mask = (unsigned) _mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, needle));
+            if(mask)
+                return it + __builtin_ctz(mask);
+        }
+#elif defined(FIRE_SSE2_ENABLED_)
+        const __m128i needle = _mm_set1_epi8(c);
+        for(; end - it >= 16; it += 16) {
+            __m128i chunk = _mm_loadu_si128((const __m128i *) it);
+            unsigned mask = (unsigned) _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, needle));
+            if(mask)
+                return it + __builtin_ctz(mask);
+        }
+#endif
+        for(; it < end; ++it)
+            if(*it == c)
+                return it;
+        return end;
+    }
+
     std::string without_hyphens(const std::string &s) {
         int hyphens = count_hyphens(s);
         std::string wo_hyphens = s.substr(hyphens);
@@ -344,7 +1450,7 @@ namespace fire {
         return name;
     }
 
-    inline identifier::identifier(const std::vector<std::string> &names, optional<int> pos, bool is_variadic) {
+    identifier::identifier(const std::vector<std::string> &names, optional<int> pos, bool is_variadic) {
         _variadic = is_variadic;
 
         // Find description, shorthand and long name
@@ -355,27 +1461,27 @@ namespace fire {
             }
 
             int hyphens = count_hyphens(name);
-            _instant_assert(hyphens <= 2, "Identifier entry " + name + " must prefix either:"
-                                          " 0 hyphens for description,"
-                                          " 1 hyphen for short-hand name"
-                                          " 2 hyphens for long name");
+            _instant_assert(hyphens <= 2, _message("Identifier entry ", name, " must prefix either:"
+                                                   " 0 hyphens for description,"
+                                                   " 1 hyphen for short-hand name"
+                                                   " 2 hyphens for long name"));
             if(hyphens == 0) {
                 _instant_assert(! _descr.has_value(),
-                        "Can't specify descriptions twice: " + _descr.value_or("") + " and " + name);
+                        _message("Can't specify descriptions twice: ", _descr.value_or(""), " and ", name));
                 _descr = name;
             } else if(hyphens == 1) {
                 _instant_assert(! _short_name.has_value(),
-                        "Can't specify shorthands twice: " + _short_name.value_or("") + " and " + name);
+                        _message("Can't specify shorthands twice: ", _short_name.value_or(""), " and ", name));
                 _instant_assert(name.size() == 2,
-                        "Single hyphen shorthand " + name + " must be one character");
+                        _message("Single hyphen shorthand ", name, " must be one character"));
                 _instant_assert(! isdigit(name[1]),
-                        "Argument " + name + " can't start with a number");
+                        _message("Argument ", name, " can't start with a number"));
                 _short_name = name;
             } else if(hyphens == 2) {
                 _instant_assert(! _long_name.has_value(),
-                        "Can't specify long names twice: " + _long_name.value_or("") + " and " + name);
+                        _message("Can't specify long names twice: ", _long_name.value_or(""), " and ", name));
                 _instant_assert(name.size() >= 4,
-                                "Two hyphen name " + name + " must have at least two characters");
+                                _message("Two hyphen name ", name, " must have at least two characters"));
                 _long_name = name;
             }
         }
@@ -389,21 +1495,18 @@ namespace fire {
             return;
         }
 
-        // Set help and longer variant
-        if(_long_name.has_value() && _short_name.has_value()) {
-            _help = _short_name.value() + "|" + _long_name.value();
-            _longer = _long_name.value();
-        } else if (_long_name.has_value() && ! _short_name.has_value())
-            _help = _longer = _long_name.value();
-        else if (! _long_name.has_value() && _short_name.has_value())
-            _help = _longer = _short_name.value();
+        if(_short_name.has_value())
+            _short_hash = _string_view_hash()(_short_name.value());
+        if(_long_name.has_value())
+            _long_hash = _string_view_hash()(_long_name.value());
+        _set_named_help();
 
         // Set position
         if(pos.has_value()) {
             _instant_assert(! _short_name.has_value(),
-                    "Can't specify both name " + _short_name.value_or("") + " and index " + std::to_string(pos.value()));
+                    _message("Can't specify both name ", _short_name.value_or(""), " and index ", pos.value()));
             _instant_assert(! _long_name.has_value(),
-                    "Can't specify both name " + _long_name.value_or("") + " and index " + std::to_string(pos.value()));
+                    _message("Can't specify both name ", _long_name.value_or(""), " and index ", pos.value()));
             _pos = pos;
             if(_pos_name.has_value())
                 _longer = _help = _pos_name.value();
@@ -415,10 +1518,31 @@ namespace fire {
 
         if(_pos_name.has_value())
             _instant_assert(_pos.has_value(),
-                    "Positional name " + _pos_name.value_or("") + " requires the argument to be positional");
+                    _message("Positional name ", _pos_name.value_or(""), " requires the argument to be positional"));
+    }
+
+#ifdef FIRE_STATIC_IDENTIFIERS_ENABLED_
+    identifier::identifier(const _static_names &names) {
+        if(names.short_name) _short_name = std::string(names.short_name);
+        if(names.long_name) _long_name = std::string(names.long_name);
+        if(names.descr) _descr = std::string(names.descr);
+        _short_hash = names.short_hash;
+        _long_hash = names.long_hash;
+        _set_named_help();
+    }
+#endif
+
+    void identifier::_set_named_help() {
+        if(_long_name.has_value() && _short_name.has_value()) {
+            _help = _short_name.value() + "|" + _long_name.value();
+            _longer = _long_name.value();
+        } else if (_long_name.has_value() && ! _short_name.has_value())
+            _help = _longer = _long_name.value();
+        else if (! _long_name.has_value() && _short_name.has_value())
+            _help = _longer = _short_name.value();
     }
 
-    inline identifier::type identifier::get_type() const {
+    identifier::type identifier::get_type() const {
         if(_variadic || _pos.has_value())
             return type::positional;
         if(flag)
@@ -469,6 +1593,7 @@ namespace fire {
     bool identifier::contains(int pos) const {
         return _pos.has_value() && pos == _pos.value();
     }
+#endif
 
 
     template<typename ORDER, typename VALUE>
@@ -486,82 +1611,154 @@ namespace fire {
     }
 
 
-    _matcher::_matcher(int argc, const char **argv, int main_args, bool strict) {
+#ifdef FIRE_DEFINITIONS_ENABLED_
+    _matcher::_matcher(int argc, const char **argv, int main_args, bool strict, bool borrow_argv, _arena *memory) {
         _main_args = main_args;
         _strict = strict;
 
-        parse(argc, argv);
-        identifier help({"-h", "--help", "Print the help message"}, optional<int>());
+        if(! memory)
+            _own_memory.reset(memory = new _arena());
+        _memory = memory;
+        _positional = _views(_memory);
+        _named = decltype(_named)(_memory);
+        _named_index = _name_index(0, _hashed_view::hasher(), std::equal_to<_hashed_view>(), _memory);
+        _queried_names = _name_set(0, _hashed_view::hasher(), std::equal_to<_hashed_view>(), _memory);
+        _named_queried = _arena_vector<bool>(_memory);
+        _positional_queried = _arena_vector<bool>(_memory);
+
+        parse(argc, argv, borrow_argv);
+        static const identifier help({"-h", "--help", "Print the help message"}, optional<int>()); // Built once
         _help_flag = get_and_mark_as_queried(help).second != arg_type::none_t;
         check(false);
     }
 
+    _matcher::~_matcher() {
+        // Hash tables touch their nodes and buckets on destruction, so they're released while an owned arena exists
+        _named_index = _name_index();
+        _queried_names = _name_set();
+    }
+
+    bool _matcher::needs_introspection(int argc, const char **argv) {
+        // Introspection only finds arguments expecting a value, which equate_assignments() needs for `-j8` and
+        // `-j 8`. If no token can take either form, the command line is parsed identically without it.
+        for(int i = 1; i < argc; ++i) {
+            _string_view s = argv[i];
+            if(s == "--")
+                return false;
+            if(s.size() >= 2 && s[0] == '@' && _::active().response_files()) // Contents aren't known yet
+                return true;
+
+            int hyphens = count_hyphens(s);
+            if(hyphens == 1 && s.size() >= 2 && isdigit((unsigned char) s[1])) // Negative numbers can't be names
+                continue;
+            if(hyphens == 1 && s.size() > 2 && s[2] != '=')
+                return true;
+            if((hyphens == 1 || hyphens == 2) && s.find('=') == _string_view::npos
+                    && i + 1 < argc && _string_view(argv[i + 1]) != "--")
+                return true;
+        }
+        return false;
+    }
+
     void _matcher::check(bool dec_main_args) {
         _main_args -= dec_main_args;
         if(! _strict || _main_args > 0) return;
 
         if(_help_flag) {
-            _::logger.print_help();
-            exit(0);
+            _::logger().print_help();
+            _exit_program(0);
         }
 
-        check_named();
-        check_positional();
+        {
+            FIRE_STATS_PHASE_(check);
+            check_named();
+            check_positional();
+        }
+#ifdef FIRE_STATS
+        _::stats().report(_named.size(), _positional.size(), _::logger().size(), _memory);
+#endif
 
         if(! _deferred_error.empty()) {
-            std::cerr << "Error: " << _deferred_error.get() << std::endl;
-            exit(_failure_code);
+            _write_stderr("Error: " + _deferred_error.get() + "\n");
+            _exit_program(_failure_code);
         }
+        _checked = true;
     }
 
     void _matcher::check_named() {
         int invalid_count = 0;
         std::string invalid;
-        for(const auto &it: _named) {
-            for(const auto &jt: _queried)
-                if(jt.contains(it.first))
-                    goto VALID;
+        for(size_t i = 0; i < _named.size(); ++i) {
+            // Only the first occurrence of a name is marked, repeated names are reported by parse()
+            if(_named_queried[i] || _named_queried[_named_index.find(_named[i].first)->second])
+                continue;
 
             ++invalid_count;
-            invalid += " " + it.first;
-            VALID:;
+            invalid += " " + _named[i].first.str();
         }
-        deferred_assert(identifier(), invalid.empty(),
-                        std::string("invalid argument") + (invalid_count > 1 ? "s" : "") + invalid);
+        deferred_assert(identifier(), invalid.empty(), _message("invalid argument", invalid_count > 1 ? "s" : "", invalid));
     }
 
     void _matcher::check_positional() {
         int invalid_count = 0;
         std::string invalid;
         for(size_t i = 0; i < _positional.size(); ++i) {
-            for(const auto &it: _queried)
-                if(it.contains((int) i))
-                    goto VALID;
+            if(i < _queried_positional_prefix || (i < _positional_queried.size() && _positional_queried[i]))
+                continue;
 
             ++invalid_count;
-            invalid += " " + _positional[i];
-            VALID:;
+            invalid += " " + _positional[i].str();
         }
         deferred_assert(identifier(), invalid.empty(),
-                        std::string("invalid positional argument") + (invalid_count > 1 ? "s" : "") + invalid);
+                        _message("invalid positional argument", invalid_count > 1 ? "s" : "", invalid));
     }
 
-    std::pair<std::string, _matcher::arg_type> _matcher::get_and_mark_as_queried(const identifier &id) {
-        for(const auto& it: _queried)
-            _instant_assert(! it.overlaps(id), "double query for argument " + id.longer());
-
-        if (_strict)
-            _queried.push_back(id);
+    std::pair<_string_view, _matcher::arg_type> _matcher::get_and_mark_as_queried(const identifier &id) {
+        const optional<std::string> &short_name = id.short_name(), &long_name = id.long_name();
+
+        if (_strict) {
+            bool overlaps = false;
+            // Names are copied, because the identifier doesn't outlive its fire::arg
+            if(short_name.has_value())
+                overlaps |= ! _queried_names.emplace(store(short_name.value().data(), short_name.value().size()),
+                                                     id.short_hash()).second;
+            if(long_name.has_value())
+                overlaps |= ! _queried_names.emplace(store(long_name.value().data(), long_name.value().size()),
+                                                     id.long_hash()).second;
+            if(id.get_pos().has_value()) {
+                size_t pos = id.get_pos().value();
+                if(pos >= _positional_queried.size())
+                    _positional_queried.resize(pos + 1);
+                overlaps |= pos < _queried_positional_prefix || _positional_queried[pos];
+                _positional_queried[pos] = true;
+            }
+            _instant_assert(! overlaps, _message("double query for argument ", id.longer()));
+        }
 
-        for(auto it = _named.begin(); it != _named.end(); ++it) {
-            if (id.contains(it->first)) {
-                optional<std::string> result = it->second;
-                if (result.has_value())
-                    return {result.value(), arg_type::string_t};
-                return {"", arg_type::bool_t};
+        // If both names were supplied, the one occurring first on command line is used
+        size_t index = _named.size();
+        if(short_name.has_value()) {
+            auto it = _named_index.find(_hashed_view(short_name.value(), id.short_hash()));
+            if(it != _named_index.end()) {
+                index = std::min(index, it->second);
+                _named_queried[it->second] = true;
+            }
+        }
+        if(long_name.has_value()) {
+            auto it = _named_index.find(_hashed_view(long_name.value(), id.long_hash()));
+            if(it != _named_index.end()) {
+                index = std::min(index, it->second);
+                _named_queried[it->second] = true;
             }
         }
 
+        if(index < _named.size()) {
+            const optional<_string_view> &result = _named[index].second;
+            if (result.has_value())
+                return {result.value(), arg_type::string_t};
+            return {"", arg_type::bool_t};
+        }
+
         if(id.get_pos().has_value()) {
             size_t pos = id.get_pos().value();
             if(pos >= _positional.size())
@@ -573,52 +1770,240 @@ namespace fire {
         return {"", arg_type::none_t};
     }
 
-    void _matcher::parse(int argc, const char **argv) {
-        _executable = argv[0];
-        std::vector<std::string> raw = to_vector_string(argc - 1, argv + 1);
-        std::vector<std::string> eqs = equate_assignments(raw, _::logger.get_assignment_arguments());
-        std::vector<std::string> named;
+    const _arena_vector<_string_view>& _matcher::get_and_mark_all_positional_as_queried() {
+        if (_strict && ! _positional.empty()) {
+            int overlap = (int) _positional.size();
+            if(_queried_positional_prefix > 0)
+                overlap = 0;
+            for(size_t pos = 0; pos < _positional_queried.size(); ++pos)
+                if(_positional_queried[pos]) {
+                    overlap = std::min(overlap, (int) pos);
+                    break;
+                }
+            _instant_assert(overlap == (int) _positional.size(),
+                            _message("double query for argument <", overlap, ">"));
+            _queried_positional_prefix = _positional.size();
+        }
+
+        return _positional;
+    }
+
+    void _matcher::parse(int argc, const char **argv, bool borrow_argv) {
+        _executable = borrow_argv ? _string_view(argv[0]) : store(argv[0], strlen(argv[0]));
+        _views raw = to_views(argc - 1, argv + 1, borrow_argv);
+        if(_::active().response_files())
+            raw = expand_response_files(raw);
+        _tokens eqs = equate_assignments(scan(raw), _::active().assignment_arguments());
+        _tokens named(_memory);
         tie(named, _positional) = separate_named_positional(eqs);
         named = expand_single_hyphen(named);
         _named = assign_named_values(named);
 
+        _named_queried.assign(_named.size(), false);
+        _named_index.reserve(_named.size());
         for(size_t i = 0; i < _named.size(); ++i)
-            for(size_t j = 0; j < i; ++j)
-                deferred_assert(identifier(), _named[i].first != _named[j].first,
-                                "multiple occurrences of argument " + identifier::prepend_hyphens(_named[i].first));
+            if(! _named_index.emplace(_named[i].first, i).second)
+                deferred_assert(identifier(), false, _message("multiple occurrences of argument ", _named[i].first));
     }
 
-    std::vector<std::string> _matcher::to_vector_string(int n_strings, const char **strings) {
-        std::vector<std::string> raw(n_strings);
+    _matcher::_views _matcher::to_views(int n_strings, const char **strings, bool borrow) {
+        _views raw((size_t) n_strings, _string_view(), _memory);
         for(int i = 0; i < n_strings; ++i)
             raw[i] = strings[i];
+        if(borrow)
+            return raw;
+
+        // Copy all tokens into a single buffer, so the matcher doesn't depend on argv's lifetime
+        size_t total = 0;
+        for(const _string_view &s: raw)
+            total += s.size() + 1;
+
+        char *dest = (char *) _memory->allocate(total, 1);
+        for(_string_view &s: raw) {
+            memcpy(dest, s.data(), s.size() + 1);
+            s = _string_view(dest, s.size());
+            dest += s.size() + 1;
+        }
         return raw;
     }
 
-    std::vector<std::string> _matcher::equate_assignments(
-            const std::vector<std::string> &raw, const std::vector<std::string> &assigned) {
-        std::vector<std::string> eqs;
+    _matcher::_views _matcher::expand_response_files(const _views &raw) {
+        // `@path` is replaced by arguments read from path, unless the file can't be read (like gcc does).
+        // Tokens after "--" and tokens inside response files aren't expanded.
+        bool any = false;
+        for(const _string_view &s: raw)
+            any |= s.size() >= 2 && s[0] == '@';
+        if(! any)
+            return raw;
+
+        _views expanded(_memory);
+        expanded.reserve(raw.size());
+        for(size_t i = 0; i < raw.size(); ++i) {
+            const _string_view &s = raw[i];
+            if(s == "--") {
+                expanded.insert(expanded.end(), raw.begin() + i, raw.end());
+                break;
+            }
+
+            _mapped_file file;
+            if(s.size() >= 2 && s[0] == '@')
+                file = _mapped_file(s.substr(1).str());
+            if(! file.is_open()) {
+                expanded.push_back(s);
+                continue;
+            }
+
+            tokenize_response_file(file.data(), file.size(), expanded);
+            _response_files.push_back(std::move(file));
+        }
+        return expanded;
+    }
+
+    void _matcher::tokenize_response_file(char *data, size_t size, _views &tokens) {
+        if(size == 0) // Empty files aren't mapped, data is null
+            return;
+        char *end = data + size;
+
+        // Null-terminated arguments (eg. from `find -print0`) are taken verbatim
+        if(memchr(data, '\0', size)) {
+            for(char *it = data; it < end; ) {
+                char *token_end = (char *) memchr(it, '\0', (size_t) (end - it));
+                if(! token_end)
+                    token_end = end;
+                tokens.emplace_back(it, (size_t) (token_end - it));
+                it = token_end + 1;
+            }
+            return;
+        }
+
+        // Otherwise arguments are separated by whitespace. Quotes group and backslash escapes characters,
+        // both are removed in place. Characters are only written when they move, so clean pages stay shared.
+        char *in = data;
+        while(true) {
+            while(in < end && isspace((unsigned char) *in))
+                ++in;
+            if(in == end)
+                break;
+
+            char *begin = in, *out = in, quote = 0;
+            for(; in < end; ++in) {
+                char c = *in;
+                if(c == '\\' && quote != '\'' && in + 1 < end)
+                    c = *++in;
+                else if(quote ? c == quote : (c == '\'' || c == '"')) {
+                    quote = quote ? 0 : c;
+                    continue;
+                } else if(! quote && isspace((unsigned char) c))
+                    break;
+
+                if(out != in)
+                    *out = c;
+                ++out;
+            }
+            tokens.emplace_back(begin, (size_t) (out - begin));
+        }
+    }
+
+    _string_view _matcher::store(const char *data, size_t size) {
+        char *copy = (char *) _memory->allocate(size + 1, 1);
+        memcpy(copy, data, size);
+        copy[size] = '\0';
+        return _string_view(copy, size);
+    }
+
+    _matcher::_tokens _matcher::scan(const _views &raw) {
+        _tokens tokens(_memory);
+        tokens.reserve(raw.size());
+        bool contiguous = true;
+        for(size_t i = 0; i < raw.size(); ++i) {
+            tokens.push_back(_token(raw[i], _string_view::npos, count_hyphens(raw[i])));
+            contiguous &= i == 0 || raw[i].data() == raw[i - 1].data() + raw[i - 1].size() + 1;
+        }
+
+        if(! contiguous) {
+            for(_token &token: tokens)
+                token.eq = token.str.find('=');
+            return tokens;
+        }
+
+        // Strings of argv are usually stored back to back, so the first '=' of every token is found in one pass
+        const char *it = raw.empty() ? nullptr : raw.front().data();
+        const char *end = raw.empty() ? nullptr : raw.back().data() + raw.back().size();
+        size_t i = 0;
+        while((it = _find_char(it, end, '=')) != end) {
+            while(it >= tokens[i].str.data() + tokens[i].str.size())
+                ++i;
+            if(it < tokens[i].str.data()) { // Separator between tokens
+                it = tokens[i].str.data();
+                continue;
+            }
+            tokens[i].eq = (size_t) (it - tokens[i].str.data());
+            it = tokens[i].str.data() + tokens[i].str.size();
+        }
+        return tokens;
+    }
+
+    _token _matcher::materialize(const _string_view &name, const _string_view &value) {
+        char *eq = (char *) _memory->allocate(name.size() + value.size() + 2, 1);
+        memcpy(eq, name.data(), name.size());
+        eq[name.size()] = '=';
+        memcpy(eq + name.size() + 1, value.data(), value.size());
+        eq[name.size() + 1 + value.size()] = '\0';
+        _string_view str(eq, name.size() + 1 + value.size());
+        return _token(str, str.find('='), count_hyphens(name));
+    }
+
+    _assignment_table::_assignment_table(const std::vector<std::string> &names) {
+        size_t total = 0;
+        for(const std::string &name: names)
+            total += name.size();
+        _names.resize(total);
+
+        char *dest = _names.data();
+        for(const std::string &name: names) {
+            if(name.size() == 2 && name[0] == '-' && (unsigned char) name[1] < 128) {
+                _short[(unsigned char) name[1]] = true;
+                continue;
+            }
+            memcpy(dest, name.data(), name.size());
+            _long.emplace(_string_view(dest, name.size()));
+            dest += name.size();
+        }
+    }
+
+    bool _assignment_table::contains(const _string_view &name) const {
+        if(name.size() < 2 || name[0] != '-')
+            return false;
+        if(name.size() == 2 && (unsigned char) name[1] < 128)
+            return _short[(unsigned char) name[1]];
+        return _long.count(_hashed_view(name)) > 0;
+    }
+
+    _matcher::_tokens _matcher::equate_assignments(const _tokens &raw, const _assignment_table &assigned) {
+        _tokens eqs(_memory);
+        eqs.reserve(raw.size());
         size_t i = 0;
         while(i < raw.size()) {
             // Don't parse options after "--"
-            if(raw[i] == "--" || (i + 1 < raw.size() && raw[i + 1] == "--")) {
+            if(raw[i].separator() || (i + 1 < raw.size() && raw[i + 1].separator())) {
                 eqs.insert(eqs.end(), raw.begin() + i, raw.end());
                 break;
             }
 
             // Parse `make -j8` as `make -j=8`
-            if(count_hyphens(raw[i]) == 1 && raw[i].size() > 2 && raw[i][2] != '=') {
-                std::string prefix = raw[i].substr(0, 2);
-                if(std::find(assigned.begin(), assigned.end(), prefix) != assigned.end()) {
-                    eqs.push_back(prefix + "=" + raw[i].substr(2));
+            const _string_view &s = raw[i].str;
+            if(raw[i].hyphens == 1 && s.size() > 2 && s[2] != '=') {
+                _string_view prefix = s.substr(0, 2);
+                if(assigned.contains(prefix)) {
+                    eqs.push_back(materialize(prefix, s.substr(2)));
                     ++i;
                     continue;
                 }
             }
 
             // Parse `make -j 8` as `make -j=8`
-            if(i < raw.size() - 1 && std::find(assigned.begin(), assigned.end(), raw[i]) != assigned.end()) {
-                eqs.push_back(raw[i] + "=" + raw[i + 1]);
+            if(i < raw.size() - 1 && assigned.contains(s)) {
+                eqs.push_back(materialize(s, raw[i + 1].str));
                 i += 2;
                 continue;
             }
@@ -631,82 +2016,229 @@ namespace fire {
         return eqs;
     }
 
-    std::tuple<std::vector<std::string>, std::vector<std::string>>
-            _matcher::separate_named_positional(const std::vector<std::string> &eqs) {
-        std::vector<std::string> named, positional;
+    std::tuple<_matcher::_tokens, _matcher::_views> _matcher::separate_named_positional(const _tokens &eqs) {
+        _tokens named(_memory);
+        _views positional(_memory);
 
         for(size_t i = 0; i < eqs.size(); ++i) {
-            const std::string &s = eqs[i];
-            int hyphens = count_hyphens(s);
+            const _token &t = eqs[i];
 
-            if(s == "--") { // Double dash indicates that upcoming arguments are positional only
-                positional.insert(positional.end(), eqs.begin() + i + 1, eqs.end());
+            if(t.separator()) { // Double dash indicates that upcoming arguments are positional only
+                for(++i; i < eqs.size(); ++i)
+                    positional.push_back(eqs[i].str);
                 break;
             }
 
-            deferred_assert(identifier(), hyphens <= 2, "too many hyphens: " + s);
-            if((hyphens == 1 && !isdigit(s[1])) || hyphens == 2)
-                named.push_back(s);
+            if(t.hyphens > 2)
+                deferred_assert(identifier(), false, _message("too many hyphens: ", t.str));
+            if((t.hyphens == 1 && !(t.str.size() > 1 && isdigit(t.str[1]))) || t.hyphens == 2)
+                named.push_back(t);
             else
-                positional.push_back(s);
+                positional.push_back(t.str);
         }
 
-        return std::tuple<std::vector<std::string>, std::vector<std::string>>(named, positional);
+        return std::tuple<_tokens, _views>(std::move(named), std::move(positional));
     }
 
-    std::vector<std::string> _matcher::expand_single_hyphen(const std::vector<std::string> &named) {
-        std::vector<std::string> new_named;
-        for(const std::string &s: named) {
-            int hyphens = count_hyphens(s);
-            if(hyphens == 1 && s.find('=') != std::string::npos && s.find('=') >= 3) {
+    _matcher::_tokens _matcher::expand_single_hyphen(const _tokens &named) {
+        _tokens new_named(_memory);
+        new_named.reserve(named.size());
+        for(const _token &t: named) {
+            if(t.hyphens == 1 && t.eq != _string_view::npos && t.eq >= 3) {
                 deferred_assert(identifier(), false,
-                        "expanding single-hyphen arguments can't have value (" + s + ")");
+                        _message("expanding single-hyphen arguments can't have value (", t.str, ")"));
                 continue;
             }
 
-            if(hyphens == 1 && s.find('=') == std::string::npos)
-                for(size_t i = 1; i < s.size(); ++i) {
-                    new_named.push_back(std::string("-") + s[i]);
+            if(t.hyphens == 1 && t.eq == _string_view::npos)
+                for(size_t i = 1; i < t.str.size(); ++i) {
+                    int hyphens = t.str[i] == '-' ? 2 : 1;
+                    new_named.push_back(_token(_single_hyphen_name(t.str[i]), _string_view::npos, hyphens));
                 }
             else
-                new_named.push_back(s);
+                new_named.push_back(t);
         }
         return new_named;
     }
 
-    std::vector<std::pair<std::string, optional<std::string>>>
-            _matcher::assign_named_values(const std::vector<std::string> &named) {
-        std::vector<std::pair<std::string, optional<std::string>>> args;
-
-        for(const std::string &eq: named) {
-            size_t index = eq.find('=');
-            size_t hyphens = count_hyphens(eq);
-            std::string name = eq;
-            if(index == std::string::npos) {
-                args.emplace_back(eq, optional<std::string>());
+    _arena_vector<std::pair<_string_view, optional<_string_view>>> _matcher::assign_named_values(const _tokens &named) {
+        _arena_vector<std::pair<_string_view, optional<_string_view>>> args(_memory);
+        args.reserve(named.size());
+
+        for(const _token &t: named) {
+            const _string_view &eq = t.str;
+            size_t index = t.eq;
+            size_t hyphens = (size_t) t.hyphens;
+            _string_view name = eq;
+            if(index == _string_view::npos) {
+                args.emplace_back(eq, optional<_string_view>());
             } else {
                 name = eq.substr(0, index);
-                std::string value = eq.substr(index + 1);
-
-                args.emplace_back(name, value);
+                args.emplace_back(name, eq.substr(index + 1));
             }
             size_t name_size = eq.size() - hyphens;
-            deferred_assert(identifier(), hyphens <= 2,
-                            name + " must have at most two hyphens");
-            if(hyphens == 2)
-                deferred_assert(identifier(), name_size >= 2,
-                        "multi-character name " + name + " must have at least two hyphens");
+            if(hyphens > 2)
+                deferred_assert(identifier(), false, _message(name, " must have at most two hyphens"));
+            if(hyphens == 2 && name_size < 2)
+                deferred_assert(identifier(), false,
+                        _message("multi-character name ", name, " must have at least two hyphens"));
         }
         return args;
     }
 
-    bool _matcher::deferred_assert(const identifier &id, bool pass, const std::string &msg) {
+    _mapped_file::_mapped_file(const std::string &path) {
+#ifdef FIRE_MMAP_ENABLED_
+        int fd = open(path.c_str(), O_RDONLY);
+        if(fd < 0)
+            return;
+        struct stat info;
+        if(fstat(fd, &info) == 0 && S_ISREG(info.st_mode)) {
+            _size = (size_t) info.st_size;
+            _open = true;
+            if(_size > 0) {
+                void *mapped = mmap(nullptr, _size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+                if(mapped != MAP_FAILED)
+                    _data = (char *) mapped;
+                else
+                    _open = false;
+            }
+        }
+        close(fd);
+#else
+        FILE *file = fopen(path.c_str(), "rb");
+        if(! file)
+            return;
+        char chunk[4096];
+        for(size_t n; (n = fread(chunk, 1, sizeof(chunk), file)) > 0; )
+            _buffer.insert(_buffer.end(), chunk, chunk + n);
+        _open = ! ferror(file);
+        fclose(file);
+        _data = _buffer.data();
+        _size = _buffer.size();
+#endif
+    }
+
+    _mapped_file& _mapped_file::operator=(_mapped_file &&other) noexcept {
+        std::swap(_data, other._data);
+        std::swap(_size, other._size);
+        std::swap(_open, other._open);
+        std::swap(_buffer, other._buffer);
+        return *this;
+    }
+
+    _mapped_file::~_mapped_file() {
+#ifdef FIRE_MMAP_ENABLED_
+        if(_data)
+            munmap(_data, _size);
+#endif
+    }
+
+    _arena::_arena(void *memory, size_t size): _user((char *) memory), _user_size(memory ? size : 0) {
+        reset();
+    }
+
+    _arena::~_arena() {
+        while(_blocks) {
+            _block *next = _blocks->next;
+            ::operator delete(_blocks);
+            _blocks = next;
+        }
+    }
+
+    void* _arena::allocate(size_t size, size_t align) {
+        size_t padding = (align - (size_t) _pos % align) % align;
+        if((size_t) (_end - _pos) < padding + size) {
+            _next_block(size, align);
+            padding = (align - (size_t) _pos % align) % align;
+        }
+
+        void *ret = _pos + padding;
+        _pos += padding + size;
+        _allocated += size;
+        return ret;
+    }
+
+    void _arena::reset() {
+        _current = nullptr;
+        _pos = _user;
+        _end = _user + _user_size;
+        _allocated = 0;
+    }
+
+    size_t _arena::heap_blocks(size_t *bytes) const {
+        size_t count = 0, total = 0;
+        for(const _block *block = _blocks; block; block = block->next) {
+            ++count;
+            total += block->size;
+        }
+        if(bytes)
+            *bytes = total;
+        return count;
+    }
+
+    void _arena::_next_block(size_t size, size_t align) {
+        // Blocks kept from earlier parses are tried first. A new block is linked after the current one.
+        _block *&next = _current ? _current->next : _blocks;
+        if(next && next->size >= size + align) {
+            _current = next;
+        } else {
+            size_t previous = _current ? _current->size : _user_size;
+            size_t block_size = std::max(std::max((size_t) 4096, 2 * previous), size + align);
+            _block *block = (_block *) ::operator new(sizeof(_block) + block_size);
+            block->next = next;
+            block->size = block_size;
+            next = block;
+            _current = block;
+        }
+
+        _pos = (char *) (_current + 1);
+        _end = _pos + _current->size;
+    }
+
+#ifdef FIRE_STATS
+    _parse_stats::_parse_stats() {
+        const char *output = getenv("FIRE_STATS");
+        if(output && strcmp(output, "0") != 0)
+            _output = output;
+        _since = std::chrono::steady_clock::now();
+    }
+
+    void _parse_stats::enter(phase p) {
+        if(! enabled())
+            return;
+        auto now = std::chrono::steady_clock::now();
+        _ns[_phase] += (long long) std::chrono::duration_cast<std::chrono::nanoseconds>(now - _since).count();
+        _phase = p;
+        _since = now;
+    }
+
+    void _parse_stats::report(size_t named, size_t positional, size_t options, const _arena *memory) {
+        if(! enabled())
+            return;
+        enter(_phase);
+
+        size_t heap_bytes = 0, heap_blocks = memory ? memory->heap_blocks(&heap_bytes) : 0;
+        std::FILE *file = _output == "1" ? stderr : fopen(_output.c_str(), "a");
+        if(file) {
+            fprintf(file, "{\"named\": %zu, \"positional\": %zu, \"options\": %zu, \"introspect_ns\": %lld, "
+                          "\"parse_ns\": %lld, \"convert_ns\": %lld, \"check_ns\": %lld, \"arena_bytes\": %zu, "
+                          "\"heap_blocks\": %zu, \"heap_bytes\": %zu}\n",
+                    named, positional, options, _ns[introspect], _ns[parse], _ns[convert], _ns[check],
+                    memory ? memory->allocated() : (size_t) 0, heap_blocks, heap_bytes);
+            if(file == stderr) fflush(file);
+            else fclose(file);
+        }
+        std::fill(_ns, _ns + phase_count, 0LL); // Batch mode reports every record
+    }
+#endif
+
+    bool _matcher::deferred_assert(const identifier &id, bool pass, const _message &msg) {
         if(! _strict) {
             _instant_assert(pass, msg, false);
             return pass;
         }
         if(! pass)
-            _deferred_error.set(id, msg);
+            _deferred_error.set(id, msg.str());
         return pass;
     }
 
@@ -742,10 +2274,10 @@ namespace fire {
     void _arg_logger::print_help() {
         using id2elem = std::pair<identifier, elem>;
 
-        std::string usage = "Usage:\n  " + _::matcher.get_executable();
+        std::string usage = "Usage:\n  " + _::matcher().get_executable();
         std::string options;
 
-        std::vector<id2elem> printed(_params);
+        std::vector<id2elem> printed(_params.begin(), _params.end());
         for(id2elem &e: printed) {
             e.first.set_optional(e.second.optional);
             if(e.second.t == elem::type::none)
@@ -779,21 +2311,7 @@ namespace fire {
         if(! _program_descr.empty())
             program_descr = "\n\nDescription:" + replace_all("\n" + _program_descr, "\n", "\n  ");
 
-        std::cerr << "\n" << usage;
-        std::cerr << program_descr << "\n\n";
-        std::cerr << options << "\n";
-#ifndef FIRE_EXCEPTIONS_ENABLED_
-        for(const auto& it: printed) {
-            identifier::type cur_type = it.first.get_type();
-            if(cur_type == identifier::type::named) {
-                std::string name = it.first.longer();
-                std::cerr << "\nNotes:\n";
-                std::cerr << "  All named arguments must be supplied as an equation.\n"
-                          << "  Eg. `./program " << name << "=VALUE`, not `./program " << name << " VALUE`\n\n" << std::flush;
-                break;
-            }
-        }
-#endif
+        _write_stderr("\n" + usage + program_descr + "\n\n" + options + "\n");
     }
 
     std::vector<std::string> _arg_logger::get_assignment_arguments() const {
@@ -822,145 +2340,476 @@ namespace fire {
 
     void _arg_logger::set_introspect_count(int count) {
         _introspect_count = count;
-        _::matcher.set_introspect(_introspect_count > 0);
+        _::matcher().set_introspect(_introspect_count > 0);
     }
 
     int _arg_logger::decrease_introspect_count() {
         --_introspect_count;
-        _::matcher.set_introspect(_introspect_count > 0);
+        _::matcher().set_introspect(_introspect_count > 0);
         return _introspect_count;
     }
+#endif
 
-    template <>
-    inline optional<long long> arg::_get<long long>() {
-        auto elem = _::matcher.get_and_mark_as_queried(_id);
-        _::matcher.deferred_assert(_id, elem.second != _matcher::arg_type::bool_t,
-                                   "argument " + _id.help() + " must have value");
-        if(elem.second == _matcher::arg_type::string_t) {
-            char *end_ptr;
-            errno = 0;
-            long long converted = std::strtoll(elem.first.data(), &end_ptr, 10);
+    bool _swar_is_eight_digits(uint64_t chunk) {
+        return ((chunk & 0xF0F0F0F0F0F0F0F0) |
+                (((chunk + 0x0606060606060606) & 0xF0F0F0F0F0F0F0F0) >> 4)) == 0x3333333333333333;
+    }
+
+    uint32_t _swar_parse_eight_digits(uint64_t chunk) { // Little endian, digits must be validated
+        const uint64_t mask = 0x000000FF000000FF;
+        const uint64_t mul1 = 100 + (1000000ULL << 32);
+        const uint64_t mul2 = 1 + (10000ULL << 32);
+        chunk -= 0x3030303030303030;
+        chunk = (chunk * 10) + (chunk >> 8);
+        chunk = (((chunk & mask) * mul1) + (((chunk >> 16) & mask) * mul2)) >> 32;
+        return (uint32_t) chunk;
+    }
+
+    template <typename U>
+    bool arg::_parse_magnitude(const char *it, const char *end, int shift, bool separators, U &magnitude,
+                               bool &overflow) {
+        // Parses digits in base 10 (shift == 0) or base 2^shift, with single `_` separators between digits if
+        // separators is set.
+        // Returns false for invalid input, sets overflow if the magnitude doesn't fit U.
+        const int bits = (int) sizeof(U) * 8;
+        const int digits10 = _integer_traits<U>::digits10;
+        int digits = 0; // Significant digits in magnitude
+        bool prev_digit = false;
+
+        while(it < end) {
+#ifdef FIRE_LITTLE_ENDIAN_
+            uint64_t chunk;
+            if(shift == 0 && end - it >= 8 && digits + 8 <= digits10 && (digits > 0 || *it != '0')) {
+                memcpy(&chunk, it, 8);
+                if(_swar_is_eight_digits(chunk)) {
+                    magnitude = (U) (magnitude * 100000000ULL + _swar_parse_eight_digits(chunk));
+                    digits += 8;
+                    it += 8;
+                    prev_digit = true;
+                    continue;
+                }
+            }
+#endif
 
-            if(errno == ERANGE)
-                _::matcher.deferred_assert(_id, false, "value " + elem.first + " out of range");
+            char c = *it++;
+            if(c == '_' && separators) {
+                if(! prev_digit)
+                    return false;
+                prev_digit = false;
+                continue;
+            }
+
+            unsigned d;
+            if(c >= '0' && c <= '9') d = (unsigned) (c - '0');
+            else if(shift == 4 && (c | 0x20) >= 'a' && (c | 0x20) <= 'f') d = (unsigned) ((c | 0x20) - 'a' + 10);
+            else return false;
+            if(shift > 0 && d >> shift)
+                return false;
+            prev_digit = true;
+
+            if(digits == 0 && d == 0)
+                continue; // Leading zero
+            if(shift > 0) {
+                if(magnitude >> (bits - shift)) overflow = true;
+                else magnitude = (U) ((magnitude << shift) | d);
+            } else if(digits < digits10) {
+                magnitude = (U) (magnitude * 10 + d);
+            } else if(digits == digits10 && magnitude <= (U) ((_integer_traits<U>::max() - d) / 10)) {
+                magnitude = (U) (magnitude * 10 + d);
+            } else {
+                overflow = true;
+            }
+            ++digits;
+        }
 
-            _::matcher.deferred_assert(_id, end_ptr == elem.first.data() + elem.first.size(),
-                    "value " + elem.first + " is not an integer");
+        return prev_digit; // Some digits and no trailing separator
+    }
 
-            return converted;
+    template <typename T, typename std::enable_if<_is_integer<T>::value>::type*>
+    arg::_status arg::_parse(const _string_view &str, T &value, bool literals) {
+        // Accepts an optional sign. With literals also `0x`, `0o` and `0b` prefixes and `_` digit separators
+        // (eg. 1_000_000)
+        using traits = _integer_traits<T>;
+        using U = typename traits::U;
+
+        const char *it = str.data(), *end = str.data() + str.size();
+        bool negative = it < end && *it == '-';
+        if(it < end && (*it == '-' || *it == '+'))
+            ++it;
+
+        int shift = 0;
+        if(literals && end - it > 2 && it[0] == '0') {
+            char prefix = (char) (it[1] | 0x20);
+            shift = prefix == 'x' ? 4 : prefix == 'o' ? 3 : prefix == 'b' ? 1 : 0;
+            if(shift > 0)
+                it += 2;
         }
 
-        return _int_value;
+        U magnitude = 0;
+        bool overflow = false;
+        if(! _parse_magnitude(it, end, shift, literals, magnitude, overflow))
+            return _status::not_integer;
+        if(overflow || magnitude > traits::max_magnitude(negative))
+            return _status::out_of_range;
+        if(negative && ! traits::is_signed && magnitude != 0)
+            return _status::not_positive;
+
+        value = negative ? (T) (U(0) - magnitude) : (T) magnitude;
+        return _status::valid;
     }
 
-    template <>
-    inline optional<long double> arg::_get<long double>() {
-        auto elem = _::matcher.get_and_mark_as_queried(_id);
-        _::matcher.deferred_assert(_id, elem.second != _matcher::arg_type::bool_t,
-                                   "argument " + _id.help() + " must have value");
-        if(elem.second == _matcher::arg_type::string_t) {
-            char *end_ptr;
-            errno = 0;
-            long double converted = std::strtold(elem.first.data(), &end_ptr);
+    template <typename T>
+    bool arg::_parse_fast(uint64_t mantissa, long long exponent, T &value) {
+        // Clinger's fast path: if both mantissa and 10^|exponent| are exact in W, a single multiplication or
+        // division gives a correctly rounded result. Returns false if the result can't be guaranteed.
+        using traits = _float_traits<T>;
+        using W = typename traits::W;
+        const int digits = std::numeric_limits<W>::digits;
+
+        if(! traits::fast_path || exponent < -traits::max_exact_pow10 || exponent > traits::max_exact_pow10)
+            return false;
+        if(digits < 64 && mantissa >= (uint64_t) 1 << (digits < 64 ? digits : 63))
+            return false;
+
+        int abs_exponent = (int) (exponent < 0 ? -exponent : exponent);
+        if(traits::fast_path_in_t && abs_exponent <= traits::max_exact_pow10_in_t &&
+           mantissa < (uint64_t) 1 << (traits::fast_path_in_t ? std::numeric_limits<T>::digits : 0)) { // Exact in T
+            T power = _float_traits<T>::pow10(abs_exponent);
+            value = exponent < 0 ? (T) mantissa / power : (T) mantissa * power;
+            return true;
+        }
+
+        W wide = (W) mantissa;
+        W power = _float_traits<W>::pow10(abs_exponent);
+        wide = exponent < 0 ? wide / power : wide * power;
+
+        if(wide > (W) std::numeric_limits<T>::max()) {
+            value = std::numeric_limits<T>::infinity();
+            return true;
+        }
+
+        T narrow = (T) wide;
+        if((W) narrow != wide) {
+            // Rounding to W and then to T is only wrong if wide is exactly halfway between two values of T
+            T other = std::nextafter(narrow, (W) narrow < wide ? std::numeric_limits<T>::infinity() : T(0));
+            if(((W) narrow + (W) other) / 2 == wide)
+                return false;
+        }
+        value = narrow;
+        return true;
+    }
+
+    template <typename T, typename std::enable_if<std::is_floating_point<T>::value>::type*>
+    arg::_status arg::_parse(const _string_view &str, T &value, bool) {
+        // Parses [+-]digits[.digits][(e|E)[+-]digits] independently of locale and without errno
+        const char *it = str.data(), *end = str.data() + str.size();
+        bool negative = it < end && *it == '-';
+        if(it < end && (*it == '-' || *it == '+'))
+            ++it;
+
+        const char *mantissa_begin = it;
+        uint64_t mantissa = 0;
+        int digits = 0; // Significant digits in mantissa, at most 19
+        long long exponent = 0, fraction_digits = 0;
+        bool point = false, any_digit = false, truncated = false;
+        while(it < end) {
+#ifdef FIRE_LITTLE_ENDIAN_
+            uint64_t chunk;
+            if(end - it >= 8 && digits > 0 && digits + 8 <= 19) {
+                memcpy(&chunk, it, 8);
+                if(_swar_is_eight_digits(chunk)) {
+                    mantissa = mantissa * 100000000 + _swar_parse_eight_digits(chunk);
+                    digits += 8;
+                    exponent -= point ? 8 : 0;
+                    fraction_digits += point ? 8 : 0;
+                    it += 8;
+                    continue;
+                }
+            }
+#endif
+
+            char c = *it;
+            if(c == '.' && ! point) {
+                point = true;
+                ++it;
+                continue;
+            }
+            if(c < '0' || c > '9')
+                break;
+            ++it;
+
+            unsigned d = (unsigned) (c - '0');
+            any_digit = true;
+            fraction_digits += point;
+            if(digits == 0 && d == 0) { // Leading zero
+                exponent -= point;
+            } else if(digits < 19) {
+                mantissa = mantissa * 10 + d;
+                ++digits;
+                exponent -= point;
+            } else { // Digit doesn't fit the mantissa
+                truncated |= d != 0;
+                exponent += ! point;
+            }
+        }
+        const char *mantissa_end = it;
+
+        long long explicit_exponent = 0;
+        if(it < end && (*it | 0x20) == 'e') {
+            ++it;
+            bool negative_exponent = it < end && *it == '-';
+            if(it < end && (*it == '-' || *it == '+'))
+                ++it;
+            if(it == end)
+                return _status::not_real;
+            for(; it < end && *it >= '0' && *it <= '9'; ++it)
+                if(explicit_exponent < 100000) // Way beyond the range of any floating point type
+                    explicit_exponent = explicit_exponent * 10 + (*it - '0');
+            if(negative_exponent)
+                explicit_exponent = -explicit_exponent;
+        }
+        if(it != end || ! any_digit)
+            return _status::not_real;
+
+        if(mantissa == 0) {
+            value = negative ? -T(0) : T(0);
+            return _status::valid;
+        }
+
+        if(truncated || ! _parse_fast(mantissa, exponent + explicit_exponent, value)) {
+            // Rare inputs are delegated to strtod family. The decimal point is left out, so locale doesn't matter
+            std::string digits_only;
+            digits_only.reserve((size_t) (mantissa_end - mantissa_begin) + 24);
+            for(const char *c = mantissa_begin; c < mantissa_end; ++c)
+                if(*c != '.')
+                    digits_only += *c;
+            digits_only += "e" + std::to_string(explicit_exponent - fraction_digits);
+            _strtofp(digits_only.c_str(), value);
+
+            long double wide = 0;
+            if(value == 0 && (_strtofp(digits_only.c_str(), wide), wide != 0)) { // Narrowed to zero, like a cast
+                value = negative ? -T(0) : T(0);
+                return _status::valid;
+            }
+        }
 
-            if(errno == ERANGE)
-                _::matcher.deferred_assert(_id, false, "value " + elem.first + " out of range");
+        if(std::isinf(value) || value == 0) // Overflow, or underflow even of long double
+            return _status::out_of_range;
+        if(negative)
+            value = -value;
+        return _status::valid;
+    }
 
-            _::matcher.deferred_assert(_id, end_ptr == elem.first.data() + elem.first.size(),
-                                       "value " + elem.first + " is not a real number");
+    template <typename T, typename std::enable_if<_is_integer<T>::value>::type*>
+    arg::_type arg::_describe() {
+        using W = typename std::conditional<(sizeof(T) > sizeof(long long)), T, typename std::conditional<
+                  _integer_traits<T>::is_signed, long long, unsigned long long>::type>::type;
+        return {_arg_logger::elem::type::integer, sizeof(T), _integer_traits<T>::is_signed, _parse_erased<W>};
+    }
 
-            return converted;
+#ifdef FIRE_DEFINITIONS_ENABLED_
+    std::string arg::_error_message(_status status, const identifier &id, const std::string &value) {
+        switch(status) {
+            case _status::not_integer: return "value " + value + " is not an integer";
+            case _status::not_real: return "value " + value + " is not a real number";
+            case _status::not_positive: return "argument " + id.help() + " must be positive";
+            case _status::out_of_range: return "value " + value + " out of range";
+            default: return "";
         }
+    }
 
-        if(_float_value.has_value()) return _float_value;
-        if(_int_value.has_value()) return (long double) _int_value.value();
-        return {};
+    arg::_status arg::_parse_value(const _type &type, const _string_view &str, void *value, bool literals) {
+        if(type.kind != _arg_logger::elem::type::integer || type.size > sizeof(long long))
+            return type.parse(str, value, literals);
+
+        _status status;
+        if(type.is_signed) {
+            long long wide = 0;
+            status = type.parse(str, &wide, literals);
+            unsigned long long magnitude = wide < 0 ? 0 - (unsigned long long) wide : (unsigned long long) wide;
+            if(status == _status::valid)
+                status = _store_integer(type, wide < 0, magnitude, value);
+        } else {
+            unsigned long long wide = 0;
+            status = type.parse(str, &wide, literals);
+            if(status == _status::valid)
+                status = _store_integer(type, false, wide, value);
+        }
+        return status;
     }
 
-    template <>
-    inline optional<std::string> arg::_get<std::string>() {
-        auto elem = _::matcher.get_and_mark_as_queried(_id);
-        _::matcher.deferred_assert(_id, elem.second != _matcher::arg_type::bool_t,
-                                   "argument " + _id.help() + " must have value");
+    arg::_status arg::_store_integer(const _type &type, bool negative, unsigned long long magnitude, void *value) {
+        if(negative && ! type.is_signed && magnitude != 0)
+            return _status::not_positive;
+#ifdef FIRE_INT128_ENABLED_
+        if(type.size > sizeof(long long)) { // Every long long fits
+            _uint128 bits = negative ? _uint128(0) - magnitude : _uint128(magnitude);
+            memcpy(value, &bits, sizeof(bits));
+            return _status::valid;
+        }
+#endif
 
-        if(elem.second == _matcher::arg_type::string_t)
-            return elem.first;
-        return _string_value;
+        unsigned long long max = type.size >= sizeof(long long) ? ~0ULL : (1ULL << (8 * type.size)) - 1;
+        if(type.is_signed)
+            max = (max >> 1) + negative;
+        if(magnitude > max)
+            return _status::out_of_range;
+
+        // Two's complement bits, truncated to the size of the type
+        unsigned long long bits = negative ? 0 - magnitude : magnitude;
+        uint8_t bits8 = (uint8_t) bits;
+        uint16_t bits16 = (uint16_t) bits;
+        uint32_t bits32 = (uint32_t) bits;
+        const void *narrow = type.size == 1 ? (const void *) &bits8 : type.size == 2 ? (const void *) &bits16 :
+                             type.size == 4 ? (const void *) &bits32 : (const void *) &bits;
+        memcpy(value, narrow, type.size);
+        return _status::valid;
     }
 
-    template <typename T, typename std::enable_if<std::is_integral<T>::value && ! std::is_same<T, bool>::value>::type*>
-    optional<T> arg::_get_with_precision() {
-        optional<long long> opt_value = _get<long long>();
-        if(! opt_value.has_value())
-            return optional<T>();
-        long long value = opt_value.value();
+    bool arg::_default_value(const _type &type, void *value) {
+        // Returns false if there's no default value. Out of range defaults are reported, but count as values
+        if(type.kind == _arg_logger::elem::type::string) {
+            if(_string_value.has_value())
+                *(std::string *) value = _string_value.value();
+            return _string_value.has_value();
+        }
 
-        bool is_signed = std::numeric_limits<T>::is_signed;
-        T min = std::numeric_limits<T>::lowest();
-        T max = std::numeric_limits<T>::max();
+        if(type.kind == _arg_logger::elem::type::integer) {
+            if(! _int_value.has_value())
+                return false;
+            long long wide = _int_value.value();
+            unsigned long long magnitude = wide < 0 ? 0 - (unsigned long long) wide : (unsigned long long) wide;
+            _status status = _store_integer(type, wide < 0, magnitude, value);
+            if(status != _status::valid)
+                _::matcher().deferred_assert(_id, false, _error_message(status, _id, std::to_string(wide)));
+            return true;
+        }
 
-        _::matcher.deferred_assert(_id, is_signed || value >= 0,
-                                   "argument " + _id.help() + " must be positive");
-        _::matcher.deferred_assert(_id, min <= value && value <= max,
-                                   "value " + std::to_string(value) + " out of range");
+        long double wide;
+        if(_float_value.has_value()) wide = _float_value.value();
+        else if(_int_value.has_value()) wide = (long double) _int_value.value();
+        else return false;
 
-        return (T) value;
+        long double max = type.size == sizeof(float) ? FLT_MAX : type.size == sizeof(double) ? DBL_MAX : LDBL_MAX;
+        if(! (-max <= wide && wide <= max)) {
+            _::matcher().deferred_assert(_id, false, _error_message(_status::out_of_range, _id, std::to_string(wide)));
+            return true;
+        }
+        float narrow_float = (float) wide;
+        double narrow_double = (double) wide;
+        const void *narrow = type.size == sizeof(float) ? (const void *) &narrow_float :
+                             type.size == sizeof(double) ? (const void *) &narrow_double : (const void *) &wide;
+        memcpy(value, narrow, type.size);
+        return true;
     }
 
-    template <typename T, typename std::enable_if<std::is_floating_point<T>::value>::type*>
-    optional<T> arg::_get_with_precision() {
-        optional<long double> opt_value = _get<long double>();
-        if(! opt_value.has_value())
-            return optional<T>();
-        long double value = opt_value.value();
+    bool arg::_convert_value(const _type &type, void *value, bool optional, bool dec_main_args) {
+        // Returns whether a value was found. value is left unchanged if not, or during introspection
+        if(_::matcher().get_introspect())
+            return false;
+        FIRE_STATS_PHASE_(convert);
 
-        T min = std::numeric_limits<T>::lowest();
-        T max = std::numeric_limits<T>::max();
+        if(optional)
+            _instant_assert(! (_int_value.has_value() || _float_value.has_value() || _string_value.has_value()),
+                            "optional argument has default value");
 
-        _::matcher.deferred_assert(_id, min <= value && value <= max,
-                                   "value " + std::to_string(value) + " out of range");
+        auto elem = _::matcher().get_and_mark_as_queried(_id);
+        _::matcher().deferred_assert(_id, elem.second != _matcher::arg_type::bool_t,
+                                   _message("argument ", _id.help(), " must have value"));
+        bool found = true;
+        if(elem.second == _matcher::arg_type::string_t) {
+            _status status = _parse_value(type, elem.first, value, _::active().integer_literals());
+            if(status != _status::valid)
+                _::matcher().deferred_assert(_id, false, _error_message(status, _id, elem.first.str()));
+        } else {
+            found = _default_value(type, value);
+        }
 
-        return (T) value;
+        if(! optional)
+            _::matcher().deferred_assert(_id, found, _message("required argument ", _id.longer(), " not provided"));
+        _::matcher().check(dec_main_args);
+        return found;
     }
+#endif
 
     template <typename T>
-    optional<T> arg::_convert_optional(bool dec_main_args) {
-        if(_::matcher.get_introspect())
-            return optional<T>();
+    size_t arg::_parse_all(const _string_view *str, size_t n, T *values, bool literals, _status &status) {
+#ifdef FIRE_PARALLEL_CONVERSION
+        const size_t max_threads = 8;
+        size_t threads = std::min((size_t) std::thread::hardware_concurrency(), max_threads);
+        if(n >= FIRE_PARALLEL_THRESHOLD && threads > 1) {
+            size_t chunk = (n + threads - 1) / threads;
+            std::vector<size_t> invalid(threads, n);
+            std::vector<_status> statuses(threads, _status::valid);
+            auto convert = [=, &invalid, &statuses](size_t t) {
+                size_t begin = std::min(n, t * chunk), count = std::min(n - begin, chunk);
+                size_t pos = _parse_all_serial(str + begin, count, values + begin, literals, statuses[t]);
+                invalid[t] = pos < count ? begin + pos : n;
+            };
+
+            std::vector<std::thread> workers;
+            for(size_t t = 1; t < threads; ++t)
+                workers.emplace_back(convert, t);
+            convert(0);
+            for(std::thread &worker: workers)
+                worker.join();
+
+            for(size_t t = 0; t < threads; ++t) { // Chunks are ordered, so this is the first invalid position
+                if(invalid[t] < n) {
+                    status = statuses[t];
+                    return invalid[t];
+                }
+            }
+            return n;
+        }
+#endif
+        return _parse_all_serial(str, n, values, literals, status);
+    }
 
-        _instant_assert(! (_int_value.has_value() || _float_value.has_value() || _string_value.has_value()),
-                        "optional argument has default value");
-        optional<T> val = _get_with_precision<T>();
-        _::matcher.check(dec_main_args);
-        return val;
+    template <typename T>
+    size_t arg::_parse_all_serial(const _string_view *str, size_t n, T *values, bool literals, _status &status) {
+        for(size_t i = 0; i < n; ++i) {
+            status = _parse(str[i], values[i], literals);
+            if(status != _status::valid)
+                return i;
+        }
+        return n;
     }
 
     template <typename T>
-    T arg::_convert(bool dec_main_args) {
-        if(_::matcher.get_introspect())
-            return T();
+    optional<T> arg::_convert_optional(bool dec_main_args) {
+        T value = T();
+        return _convert_value(_describe<T>(), &value, true, dec_main_args) ? optional<T>(value) : optional<T>();
+    }
 
-        optional<T> val = _get_with_precision<T>();
-        _::matcher.deferred_assert(_id, val.has_value(),
-                                   "required argument " + _id.longer() + " not provided");
-        _::matcher.check(dec_main_args);
-        return val.value_or(T());
+    template <typename T>
+    T arg::_convert(bool dec_main_args) {
+        T value = T();
+        _convert_value(_describe<T>(), &value, false, dec_main_args);
+        return value;
     }
 
+#ifdef FIRE_DEFINITIONS_ENABLED_
     void arg::_log(_arg_logger::elem::type t, bool optional) {
         std::string def;
         if(_int_value.has_value()) def = std::to_string(_int_value.value());
         if(_float_value.has_value()) def = std::to_string(_float_value.value());
         if(_string_value.has_value()) def = _string_value.value();
 
-        _::logger.log(_id, {_id.get_descr(), t, def, optional});
+        _::logger().log(_id, {_id.get_descr(), t, def, optional});
 
-        int count = _::logger.get_introspect_count();
+        int count = _::logger().get_introspect_count();
         if(count > 0) { // introspection is active
-            count = _::logger.decrease_introspect_count();
+            count = _::logger().decrease_introspect_count();
             if(count == 0) { // introspection ends
 #ifdef FIRE_EXCEPTIONS_ENABLED_
                 throw _escape_exception();
+#else
+                // Introspected fired_main can't be left without exceptions, so the real call is nested here
+#ifdef FIRE_STATS
+                _::stats().enter(_parse_stats::none);
+#endif
+                exit(_::active()._run_parsed());
 #endif
             }
         }
@@ -968,25 +2817,69 @@ namespace fire {
 
     arg::operator bool() {
         _instant_assert(!_int_value.has_value() && !_float_value.has_value() && !_string_value.has_value(),
-                _id.longer() + " flag parameter must not have default value");
+                _message(_id.longer(), " flag parameter must not have default value"));
 
         _log(_arg_logger::elem::type::none, true); // User sees this as flag, not boolean option
-        auto elem = _::matcher.get_and_mark_as_queried(_id);
-        _::matcher.deferred_assert(_id, elem.second != _matcher::arg_type::string_t,
-                                   "flag " + _id.help() + " must not have value");
-        _::matcher.check(true);
+        FIRE_STATS_PHASE_(convert);
+        auto elem = _::matcher().get_and_mark_as_queried(_id);
+        _::matcher().deferred_assert(_id, elem.second != _matcher::arg_type::string_t,
+                                   _message("flag ", _id.help(), " must not have value"));
+        _::matcher().check(true);
         return elem.second == _matcher::arg_type::bool_t;
     }
+#endif
 
     template <typename T>
     arg::operator std::vector<T>() {
         std::vector<T> ret;
-        for(size_t i = 0; i < _::matcher.pos_args(); ++i)
-            ret.push_back(arg((int) i)._convert<T>(false));
+        FIRE_STATS_PHASE_(convert);
+        if(! _::matcher().get_introspect()) {
+            const _arena_vector<_string_view> &positional = _::matcher().get_and_mark_all_positional_as_queried();
+            ret.resize(positional.size());
+            _status status = _status::valid;
+            size_t invalid = _parse_all(positional.data(), positional.size(), ret.data(),
+                                        _::active().integer_literals(), status);
+            if(invalid < positional.size()) {
+                identifier id(std::vector<std::string>(), (int) invalid);
+                _::matcher().deferred_assert(id, false, _error_message(status, id, positional[invalid].str()));
+            }
+        }
         _log(_arg_logger::elem::type::none, true);
-        _::matcher.check(true);
+        _::matcher().check(true);
         return ret;
     }
+
+    template <typename T, bool prevalidate>
+    arg::operator arg_range<T, prevalidate>() {
+        arg_range<T, prevalidate> ret;
+        FIRE_STATS_PHASE_(convert);
+        if(! _::matcher().get_introspect()) {
+            const _arena_vector<_string_view> &positional = _::matcher().get_and_mark_all_positional_as_queried();
+            ret = arg_range<T, prevalidate>(positional.data(), positional.data() + positional.size());
+            for(size_t i = 0; prevalidate && i < positional.size(); ++i) {
+                T value = T();
+                _status status = _parse(positional[i], value, _::active().integer_literals());
+                if(status != _status::valid) {
+                    identifier id(std::vector<std::string>(), (int) i);
+                    _::matcher().deferred_assert(id, false, _error_message(status, id, positional[i].str()));
+                }
+            }
+        }
+        _log(_arg_logger::elem::type::none, true);
+        _::matcher().check(true);
+        return ret;
+    }
+
+    template <typename T, bool prevalidate>
+    T arg_range<T, prevalidate>::_convert(const _string_view *it, size_t pos) {
+        T value = T();
+        arg::_status status = arg::_parse(*it, value, _::active().integer_literals());
+        if(status != arg::_status::valid) {
+            identifier id(std::vector<std::string>(), (int) pos);
+            _instant_assert(false, arg::_error_message(status, id, it->str()), false);
+        }
+        return value;
+    }
 }
 
 #define EXPAND( x ) x // Required to satisfy buggy MSVC compiler (https://stackoverflow.com/q/5134523/6865804)
@@ -995,41 +2888,72 @@ namespace fire {
 #define FIRE_EXTRACT_2_(first, second, ...) second
 #define FIRE_EXTRACT_2_PAD_(...) EXPAND( FIRE_EXTRACT_2_(__VA_ARGS__, "", "") )
 
-#define PREPARE_FIRE_(argc, argv, ...) \
-    int main_args = (int) fire::_get_argument_count(FIRE_EXTRACT_1_PAD_(__VA_ARGS__));\
-    \
-    fire::argc = argc;\
-    fire::argv = argv;\
-    \
-    fire::_::logger = fire::_arg_logger();\
-    fire::_::matcher = fire::_matcher();\
-    fire::_::logger.set_introspect_count(main_args);\
-    if(main_args > 0) {\
-        try {\
-            FIRE_EXTRACT_1_PAD_(__VA_ARGS__)(); /* function isn't actually executed, the last default argument will always throw */ \
-        } catch (fire::_escape_exception) {\
-        }\
-    }\
-    \
-    fire::_::matcher = fire::_matcher(fire::argc, fire::argv, main_args, true);\
-    fire::_::logger = fire::_arg_logger();
+// FIRE_RUN(parser, fired_main[, program_descr]) parses parser's command line and returns fired_main's result,
+// or the exit code of help and errors. Without exceptions, it instead exits the process with either of them
+
+#define FIRE_RUN(parser, ...) \
+    (parser).run((int) fire::_get_argument_count(FIRE_EXTRACT_1_PAD_(__VA_ARGS__)), FIRE_EXTRACT_2_PAD_(__VA_ARGS__),\
+                 [] { return (int) FIRE_EXTRACT_1_PAD_(__VA_ARGS__)(); })
+
+// Opt-in syntax of FIRE, FIRE_BATCH and FIRE_FORK_SERVER programs. Only read by the main() they define, so translation
+// units can't disagree
+
+#ifdef FIRE_RESPONSE_FILES
+#define FIRE_RESPONSE_FILES_ENABLED_ true
+#else
+#define FIRE_RESPONSE_FILES_ENABLED_ false
+#endif
+
+#ifdef FIRE_INTEGER_LITERALS
+#define FIRE_INTEGER_LITERALS_ENABLED_ true
+#else
+#define FIRE_INTEGER_LITERALS_ENABLED_ false
+#endif
+
+#define FIRE_CONFIGURE_(parser) \
+    ((parser).set_response_files(FIRE_RESPONSE_FILES_ENABLED_), \
+     (parser).set_integer_literals(FIRE_INTEGER_LITERALS_ENABLED_))
 
 // FIRE/FIRE_NO_EXCEPTIONS(fired_main[, program_descr])
 // optional parameters implemented using a trick similar to https://stackoverflow.com/a/3048361/6865804
 
 #define FIRE(...) \
 int main(int argc, const char ** argv) {\
-    PREPARE_FIRE_(argc, argv, __VA_ARGS__);\
-    fire::_::logger.set_program_descr(FIRE_EXTRACT_2_PAD_(__VA_ARGS__));\
-    return FIRE_EXTRACT_1_PAD_(__VA_ARGS__)();\
+    fire::argc = argc;\
+    fire::argv = argv;\
+    fire::parser parser(argc, argv);\
+    FIRE_CONFIGURE_(parser);\
+    return FIRE_RUN(parser, __VA_ARGS__);\
+}
+
+// FIRE_BATCH(fired_main[, program_descr]) calls fired_main for every record of null-terminated arguments
+
+#define FIRE_BATCH(...) \
+int main(int argc, const char ** argv) {\
+    fire::argc = argc;\
+    fire::argv = argv;\
+    fire::parser parser(argc, argv);\
+    FIRE_CONFIGURE_(parser);\
+    return parser.run_batch((int) fire::_get_argument_count(FIRE_EXTRACT_1_PAD_(__VA_ARGS__)),\
+        FIRE_EXTRACT_2_PAD_(__VA_ARGS__), [] { return (int) FIRE_EXTRACT_1_PAD_(__VA_ARGS__)(); });\
 }
 
-#define FIRE_NO_EXCEPTIONS(...) \
+// FIRE_FORK_SERVER(fired_main[, program_descr]) works like FIRE, but `program --fire-server=SOCKET` starts a server
+// that runs fired_main in a forked process for every fire::fork_client() call
+
+#ifdef FIRE_FORK_SERVER_ENABLED_
+#define FIRE_FORK_SERVER(...) \
 int main(int argc, const char ** argv) {\
-    int main_args = (int) fire::_get_argument_count(FIRE_EXTRACT_1_PAD_(__VA_ARGS__));\
-    fire::_::matcher = fire::_matcher(argc, argv, main_args, true);\
-    fire::_::logger.set_program_descr(FIRE_EXTRACT_2_PAD_(__VA_ARGS__));\
-    return FIRE_EXTRACT_1_PAD_(__VA_ARGS__)();\
+    fire::argc = argc;\
+    fire::argv = argv;\
+    fire::parser parser(argc, argv);\
+    FIRE_CONFIGURE_(parser);\
+    return parser.run_server((int) fire::_get_argument_count(FIRE_EXTRACT_1_PAD_(__VA_ARGS__)),\
+        FIRE_EXTRACT_2_PAD_(__VA_ARGS__), [] { return (int) FIRE_EXTRACT_1_PAD_(__VA_ARGS__)(); });\
 }
+#endif
+
+// Kept for compatibility, FIRE works the same way when exceptions are disabled
+#define FIRE_NO_EXCEPTIONS(...) FIRE(__VA_ARGS__)
 
 #endif
@@ -0,0 +1,215 @@
+
+/*
+    Copyright Kristjan Kongas 2020
+
+    Boost Software License - Version 1.0 - August 17th, 2003
+
+    Permission is hereby granted, free of charge, to any person or organization
+    obtaining a copy of the software and accompanying documentation covered by
+    this license (the "Software") to use, reproduce, display, distribute,
+    execute, and transmit the Software, and to prepare derivative works of the
+    Software, and to permit third-parties to whom the Software is furnished to
+    do so, all subject to the following:
+
+    The copyright notices in the Software and this entire statement, including
+    the above license grant, this restriction and the following disclaimer,
+    must be included in all copies of the Software, in whole or in part, and
+    all derivative works of the Software, unless such copies or derivative
+    works are solely in the form of machine-executable object code generated by
+    a source language processor.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+    SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+    FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+// Guards against superlinear parsing. Every scenario is run at N, 2N, 4N and 8N tokens and fails if time or
+// allocations grow faster than N log N (with slack for timing noise). Usage: complexity_test [N]
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+#include "fire-hpp/fire.hpp"
+
+using namespace std;
+using namespace fire;
+
+static size_t allocations = 0;
+
+void* operator new(size_t size) {
+    ++allocations;
+    if(void *p = malloc(size ? size : 1))
+        return p;
+    throw bad_alloc();
+}
+void operator delete(void *p) noexcept { free(p); }
+void operator delete(void *p, size_t) noexcept { free(p); }
+
+struct measurement {
+    double ns;
+    size_t allocations;
+};
+
+template <typename F>
+static measurement measure(F f) { // Minimum of several runs, allocations are deterministic
+    measurement best = {HUGE_VAL, 0};
+    for(int run = 0; run < 7; ++run) {
+        size_t start_allocations = allocations;
+        auto start = chrono::steady_clock::now();
+        f();
+        double ns = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+        best = {min(best.ns, ns), allocations - start_allocations};
+    }
+    return best;
+}
+
+struct command_line {
+    vector<string> args = {"complexity_test"};
+    vector<const char *> argv;
+
+    const char** data() {
+        argv.clear();
+        for(const string &arg: args)
+            argv.push_back(arg.c_str());
+        return argv.data();
+    }
+    int size() const { return (int) args.size(); }
+};
+
+static const int unlimited = 1 << 30; // main_args which never ends parsing, so errors aren't reported
+
+static measurement named(int n) { // Parsing, duplicate detection, queries and check_named()
+    command_line line;
+    vector<identifier> ids;
+    for(int i = 0; i < n; ++i) {
+        line.args.push_back("--option" + to_string(i) + "=" + to_string(i));
+        ids.emplace_back(vector<string>{"--option" + to_string(i)}, optional<int>());
+    }
+    const char **argv = line.data();
+    return measure([&] {
+        _matcher match(line.size(), argv, unlimited, true);
+        for(const identifier &id: ids)
+            match.get_and_mark_as_queried(id);
+        match.check_named();
+    });
+}
+
+static measurement duplicates(int n) { // Every name repeated, all reported as errors
+    command_line line;
+    for(int i = 0; i < n; ++i)
+        line.args.push_back("--option" + to_string(i % 4) + "=" + to_string(i));
+    const char **argv = line.data();
+    return measure([&] {
+        _matcher match(line.size(), argv, unlimited, true);
+        match.check_named();
+    });
+}
+
+static measurement expansion(int n) { // A single -abc... token
+    const string letters = "abcdefgijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ";
+    command_line line;
+    line.args.push_back("-");
+    for(int i = 0; i < n; ++i)
+        line.args.back() += letters[i % letters.size()];
+    const char **argv = line.data();
+    return measure([&] {
+        _matcher match(line.size(), argv, unlimited, true);
+        match.check_named();
+    });
+}
+
+static measurement positional(int n) { // Positional arguments queried one by one, and check_positional()
+    command_line line;
+    vector<identifier> ids;
+    for(int i = 0; i < n; ++i) {
+        line.args.push_back(to_string(i));
+        ids.emplace_back(vector<string>(), optional<int>(i));
+    }
+    const char **argv = line.data();
+    return measure([&] {
+        _matcher match(line.size(), argv, unlimited, true);
+        for(const identifier &id: ids)
+            match.get_and_mark_as_queried(id);
+        match.check_positional();
+    });
+}
+
+static measurement variadic_positional(int n) {
+    command_line line;
+    for(int i = 0; i < n; ++i)
+        line.args.push_back("file" + to_string(i));
+    const char **argv = line.data();
+    return measure([&] {
+        _matcher match(line.size(), argv, unlimited, true);
+        match.get_and_mark_all_positional_as_queried();
+        match.check_positional();
+    });
+}
+
+static vector<string> names;
+
+static int rewrite_main() {
+    int sum = 0;
+    for(const string &name: names)
+        sum += (int) arg(name.c_str());
+    return sum == 0 ? 1 : 0;
+}
+
+static measurement rewrite(int n) { // --option<i> <i> through fire::parser, which introspects and rewrites
+    command_line line;
+    names.clear();
+    for(int i = 0; i < n; ++i) {
+        names.push_back("--option" + to_string(i));
+        line.args.push_back(names.back());
+        line.args.push_back(to_string(i + 1));
+    }
+    fire::parser parser(line.size(), line.data());
+    return measure([&] {
+        if(parser.run((int) names.size(), "", rewrite_main) != 0)
+            exit(1);
+    });
+}
+
+struct scenario {
+    const char *name;
+    measurement (*run)(int n);
+};
+
+int main(int argc, const char **argv) {
+    const int base = argc > 1 ? atoi(argv[1]) : 2000, steps = 4;
+    const vector<scenario> scenarios = {{"named", named}, {"duplicates", duplicates}, {"expansion", expansion},
+                                        {"positional", positional}, {"variadic", variadic_positional},
+                                        {"rewrite", rewrite}};
+
+    // Growth from N to 8N is allowed up to 8 * log(8N) / log(N), times slack
+    double largest = base << (steps - 1);
+    double bound = largest / base * log(largest) / log((double) base);
+    const double time_slack = 2.5, allocation_slack = 1.5;
+
+    bool success = true;
+    printf("%-12s %8s %12s %12s\n", "scenario", "tokens", "us", "allocations");
+    for(const scenario &s: scenarios) {
+        vector<measurement> results;
+        for(int step = 0; step < steps; ++step) {
+            results.push_back(s.run(base << step));
+            printf("%-12s %8d %12.1f %12zu\n", s.name, base << step, results.back().ns / 1000, results.back().allocations);
+        }
+
+        double time_growth = results.back().ns / results.front().ns;
+        double allocation_growth = (double) results.back().allocations / (double) max((size_t) 1, results.front().allocations);
+        if(time_growth > bound * time_slack || allocation_growth > bound * allocation_slack) {
+            printf("%s grows superlinearly: time x%.1f, allocations x%.1f (bound x%.1f)\n",
+                   s.name, time_growth, allocation_growth, bound);
+            success = false;
+        }
+    }
+    return success ? 0 : 1;
+}
@@ -0,0 +1,194 @@
+
+/*
+    Copyright Kristjan Kongas 2020
+
+    Boost Software License - Version 1.0 - August 17th, 2003
+
+    Permission is hereby granted, free of charge, to any person or organization
+    obtaining a copy of the software and accompanying documentation covered by
+    this license (the "Software") to use, reproduce, display, distribute,
+    execute, and transmit the Software, and to prepare derivative works of the
+    Software, and to permit third-parties to whom the Software is furnished to
+    do so, all subject to the following:
+
+    The copyright notices in the Software and this entire statement, including
+    the above license grant, this restriction and the following disclaimer,
+    must be included in all copies of the Software, in whole or in part, and
+    all derivative works of the Software, unless such copies or derivative
+    works are solely in the form of machine-executable object code generated by
+    a source language processor.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+    SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+    FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+    ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+// Fuzz driver for _matcher, with two entry points:
+// - fuzz_command_line splits an input at null bytes into arguments, which are parsed in strict mode and queried
+// - fuzz_response_file tokenizes an input as the contents of a response file, then parses it as `@file`
+// Inputs whose parsing takes much longer than their size justifies are reported like crashes.
+//
+// libFuzzer: compile with `clang++ -fsanitize=fuzzer,address,undefined -DFIRE_LIBFUZZER` and run on a corpus,
+// adding -DFIRE_FUZZ_RESPONSE_FILES to fuzz response files instead of command lines.
+// Standalone: fuzz_matcher [FILE...] runs the given inputs through both entry points, or random ones if there are
+// none. FIRE_FUZZ_NS_PER_BYTE sets the time budget (default 2000 ns per input byte, plus 10 ms).
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include "fire-hpp/fire.hpp"
+
+using namespace std;
+using namespace fire;
+
+static void parse(vector<const char *> &argv) {
+    // main_args never runs out, so errors are only recorded and the process isn't exited
+    _matcher match((int) argv.size(), argv.data(), 1 << 30, true);
+    static const identifier ids[] = {
+        identifier({"-a", "--alpha"}, optional<int>()), identifier({"-b"}, optional<int>()),
+        identifier({"--gamma"}, optional<int>()), identifier({}, optional<int>(0)), identifier({}, optional<int>(2))
+    };
+    for(const identifier &id: ids)
+        match.get_and_mark_as_queried(id);
+    match.check_named();
+    match.check_positional();
+}
+
+static void check_time(chrono::steady_clock::time_point start, size_t size) {
+    static const char *ns_per_byte = getenv("FIRE_FUZZ_NS_PER_BYTE");
+    static const double budget_per_byte = ns_per_byte ? atof(ns_per_byte) : 2000;
+    double ns = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+    if(ns > 1e7 + budget_per_byte * (double) size) {
+        fprintf(stderr, "Pathological input: %zu bytes parsed in %.0f us\n", size, ns / 1000);
+        abort();
+    }
+}
+
+void fuzz_command_line(const uint8_t *data, size_t size) {
+    string input((const char *) data, size);
+    vector<const char *> argv = {"fuzz_matcher"};
+    _::active().set_response_files(false); // Would read arbitrary paths, they're fuzzed by fuzz_response_file
+    for(size_t begin = 0; begin <= size; ) {
+        size_t end = input.find('\0', begin);
+        if(end == string::npos)
+            end = size;
+        argv.push_back(input.c_str() + begin);
+        begin = end + 1;
+    }
+
+    auto start = chrono::steady_clock::now();
+    parse(argv);
+    check_time(start, size);
+}
+
+void fuzz_response_file(const uint8_t *data, size_t size) {
+    // Tokenized from an exactly sized copy, so sanitizers catch reads past the end. Empty files aren't mapped.
+    vector<char> buffer(data, data + size);
+    char *begin = buffer.empty() ? nullptr : buffer.data(), *end = begin + size;
+    _arena_vector<_string_view> tokens;
+    auto start = chrono::steady_clock::now();
+    _matcher::tokenize_response_file(begin, size, tokens);
+    check_time(start, size);
+    const char *previous = begin;
+    for(const _string_view &token: tokens) {
+        if(token.data() < previous || token.data() + token.size() > end) {
+            fprintf(stderr, "Response file token outside of its file\n");
+            abort();
+        }
+        previous = token.data() + token.size();
+    }
+
+    // The same contents through a mapped file and the whole parser
+    static string path;
+    if(path.empty()) {
+        char name[] = "/tmp/fire_fuzz_XXXXXX";
+        int fd = mkstemp(name);
+        if(fd < 0) {
+            fprintf(stderr, "Can't create a temporary file\n");
+            exit(1);
+        }
+        close(fd);
+        path = name;
+        atexit([] { remove(path.c_str()); });
+    }
+    FILE *file = fopen(path.c_str(), "wb");
+    fwrite(data, 1, size, file);
+    fclose(file);
+
+    string response = "@" + path;
+    vector<const char *> argv = {"fuzz_matcher", response.c_str()};
+    _::active().set_response_files(true);
+    start = chrono::steady_clock::now();
+    parse(argv);
+    check_time(start, size);
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+#ifdef FIRE_FUZZ_RESPONSE_FILES
+    fuzz_response_file(data, size);
+#else
+    fuzz_command_line(data, size);
+#endif
+    return 0;
+}
+
+#ifndef FIRE_LIBFUZZER
+static string read_file(const char *path) {
+    FILE *file = fopen(path, "rb");
+    if(! file) {
+        fprintf(stderr, "Can't open %s\n", path);
+        exit(1);
+    }
+    string data;
+    char chunk[4096];
+    for(size_t n; (n = fread(chunk, 1, sizeof(chunk), file)) > 0; )
+        data.append(chunk, n);
+    fclose(file);
+    return data;
+}
+
+template <size_t N>
+static string random_input(mt19937 &rng, const char *(&fragments)[N]) { // Fragments make up interesting tokens
+    size_t length = uniform_int_distribution<size_t>(0, 4)(rng) == 0 ? 1000 : 30;
+    string input;
+    for(size_t i = uniform_int_distribution<size_t>(0, length)(rng); i > 0; --i) {
+        const char *fragment = fragments[uniform_int_distribution<size_t>(0, N - 1)(rng)];
+        input.append(fragment, fragment[0] ? strlen(fragment) : 1);
+    }
+    return input;
+}
+
+int main(int argc, const char **argv) {
+    for(int i = 1; i < argc; ++i) {
+        string input = read_file(argv[i]);
+        fuzz_command_line((const uint8_t *) input.data(), input.size());
+        fuzz_response_file((const uint8_t *) input.data(), input.size());
+    }
+    if(argc > 1)
+        return 0;
+
+    static const char *argument_fragments[] = {"-", "--", "=", "\0", "\0", "\0", "a", "b", "h", "x", "gamma",
+                                               "alpha", "1", "-1", "2.5", "@", " ", "é"};
+    static const char *file_fragments[] = {"-", "--", "=", "a", "b", "x", "gamma", "1", "2.5", " ", " ", "\n",
+                                           "\t", "'", "\"", "\\", "\0", "@", "é"};
+    mt19937 rng(0);
+    for(int i = 0; i < 20000; ++i) {
+        string input = random_input(rng, argument_fragments);
+        fuzz_command_line((const uint8_t *) input.data(), input.size());
+    }
+    for(int i = 0; i < 5000; ++i) {
+        string input = random_input(rng, file_fragments);
+        fuzz_response_file((const uint8_t *) input.data(), input.size());
+    }
+    return 0;
+}
+#endif
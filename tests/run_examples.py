@@ -27,7 +27,7 @@
     DEALINGS IN THE SOFTWARE.
 """
 
-import subprocess, json
+import subprocess, json, tempfile, time, os
 from pathlib import Path
 
 fire_failure_code = 1
@@ -36,8 +36,9 @@ class assert_runner:
     test_count = 0
     check_count = 0
 
-    def __init__(self, pth):
+    def __init__(self, pth, prefix_args=()):
         self.pth = str(pth)
+        self.prefix_args = list(prefix_args)
         assert_runner.test_count += 1
         self.help_success("-h")
         self.help_success("--help")
@@ -64,7 +65,7 @@ class assert_runner:
         assert_runner.check_count += 1
 
     def run(self, cmd):
-        result = subprocess.run([self.pth] + cmd.split(), stdout=subprocess.PIPE, stderr=subprocess.PIPE)
+        result = subprocess.run([self.pth] + self.prefix_args + cmd.split(), stdout=subprocess.PIPE, stderr=subprocess.PIPE)
         stdout = self.remove_newline(self.b2str(result.stdout.strip()))
         stderr = self.remove_newline(self.b2str(result.stderr.strip()))
         code = result.returncode
@@ -85,8 +86,8 @@ def run_all_combinations(path_prefix):
     runner.equal("0 1 -i 0 --def-r 0.0 --opt-s string", "")
 
 
-def run_basic(path_prefix):
-    runner = assert_runner(path_prefix / "basic")
+def run_basic(path_prefix, name="basic"):
+    runner = assert_runner(path_prefix / name)
 
     runner.equal("-x 3 -y 4", "3 + 4 = 7")
     runner.equal("-x -3 -y 3", "-3 + 3 = 0")
@@ -96,12 +97,84 @@ def run_basic(path_prefix):
     runner.handled_failure("-x 3")
     runner.handled_failure("-y 4")
     runner.handled_failure("-x test")
+    runner.handled_failure("-x 1_0 -y 0")  # Literal syntax is opt-in
+    runner.handled_failure("-x 0x10 -y 0")
     runner.handled_failure("-x")
     runner.handled_failure("--undefined 0")
     runner.help_success("-x 0 -h")
     runner.help_success("-h --undefined")
 
 
+def run_batch(path_prefix):
+    runner = assert_runner(path_prefix / "batch")
+
+    records = b"-x\0" b"1\0\0" b"-x=2\0-y=3\0\0" b"-y\0" b"1\0\0" b"-h\0\0" b"--first\0" b"4"
+    with tempfile.TemporaryDirectory() as tmp:
+        codes_path = str(Path(tmp) / "codes")
+        result = subprocess.run([runner.pth, "-", codes_path], input=records,
+                                stdout=subprocess.PIPE, stderr=subprocess.PIPE)
+        assert result.returncode == fire_failure_code
+        assert runner.b2str(result.stdout).split() == ["1", "5", "4"]
+        assert runner.b2str(result.stderr).find("Error") != -1
+        assert runner.b2str(result.stderr).find("Usage") != -1
+        with open(codes_path) as codes:
+            assert codes.read().split() == ["0", "0", "1", "0", "0"]
+    assert_runner.check_count += 1
+
+    result = subprocess.run([runner.pth], input=b"-x=1\0\0", stdout=subprocess.PIPE, stderr=subprocess.PIPE)
+    assert result.returncode == 0
+    assert runner.b2str(result.stdout).strip() == "1"
+    assert runner.b2str(result.stderr).strip() == "0"
+    assert_runner.check_count += 1
+
+
+def run_batch_no_exceptions(path_prefix):
+    runner = assert_runner(path_prefix / "batch_no_exceptions")
+
+    result = subprocess.run([runner.pth], input=b"-x=1\0\0-x=2\0-y=3\0\0", stdout=subprocess.PIPE, stderr=subprocess.PIPE)
+    assert result.returncode == 0
+    assert runner.b2str(result.stdout).split() == ["1", "5"]
+    assert runner.b2str(result.stderr).split() == ["0", "0"]
+    assert_runner.check_count += 1
+
+    result = subprocess.run([runner.pth], input=b"-x=1\0\0-y\0\0-x=2\0\0", stdout=subprocess.PIPE, stderr=subprocess.PIPE)
+    assert result.returncode == fire_failure_code
+    assert runner.b2str(result.stdout).split() == ["1"]
+    assert runner.b2str(result.stderr).find("Error") != -1
+    assert_runner.check_count += 1
+
+
+def run_fork_server(path_prefix):
+    runner = assert_runner(path_prefix / "fork_server")
+    runner.equal("-x 3 -y 4", "3 + 4 = 7")
+
+    with tempfile.TemporaryDirectory() as tmp:
+        socket_path = Path(tmp) / "fire.sock"
+        server = subprocess.Popen([runner.pth, "--fire-server=" + str(socket_path)])
+        try:
+            for _ in range(500):
+                if socket_path.exists():
+                    break
+                time.sleep(0.01)
+
+            client = assert_runner(path_prefix / "fork_client", [str(socket_path)])
+            client.equal("-x 3 -y 4", "3 + 4 = 7")
+            client.equal("-x3 -y=4", "3 + 4 = 7")
+            client.handled_failure("-x 3")
+            client.handled_failure("-x test -y 4")
+        finally:
+            server.kill()
+            server.wait()
+
+        # A path that isn't a socket is never replaced
+        regular_path = Path(tmp) / "regular"
+        regular_path.write_text("keep")
+        result = subprocess.run([runner.pth, "--fire-server=" + str(regular_path)], stderr=subprocess.PIPE)
+        assert result.returncode == fire_failure_code
+        assert regular_path.read_text() == "keep"
+        assert_runner.check_count += 1
+
+
 def run_flag(path_prefix):
     runner = assert_runner(path_prefix / "flag")
 
@@ -150,8 +223,9 @@ def run_no_exceptions(path_prefix):
     runner.equal("", "\n")
     runner.equal("1 2", "1 2 \n")
     runner.equal("1 2 -r=2", "1 2 \n1 2 \n")
-    stdout, stderr, code = runner.run("-h")
-    assert stderr.find("Notes") != -1
+    runner.equal("1 2 -r 2", "1 2 \n1 2 \n")
+    runner.equal("-r2 1", "1 \n1 \n")
+    runner.handled_failure("-r x")
 
 
 def get_path_prefix(subdir):
@@ -168,6 +242,13 @@ def main():
 
     run_all_combinations(path_prefix)
     run_basic(path_prefix)
+    run_basic(path_prefix, "basic_no_exceptions")
+    run_basic(path_prefix, "basic_no_iostream")
+    run_basic(path_prefix, "basic_library")
+    run_batch(path_prefix)
+    run_batch_no_exceptions(path_prefix)
+    if os.name == "posix":
+        run_fork_server(path_prefix)
     run_flag(path_prefix)
     run_optional_and_default(path_prefix)
     run_positional(path_prefix)
@@ -61,6 +61,9 @@ def main():
     run(path_prefix / "run_tests")
     run_examples.main()
     run(path_prefix / "link_test")
+    run(path_prefix / "link_test_library")
+    run(path_prefix / "complexity_test")
+    run(path_prefix / "fuzz_matcher")
     print_result(True)
 
 
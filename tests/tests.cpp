@@ -28,6 +28,9 @@
 */
 
 #include <gtest/gtest.h>
+#include <fstream>
+#include <random>
+#include <thread>
 #include "fire-hpp/fire.hpp"
 
 #define EXPECT_EXIT_SUCCESS(statement) EXPECT_EXIT(statement, ::testing::ExitedWithCode(0), "")
@@ -41,8 +44,8 @@ void init_args(const vector<string> &args, bool strict, int named_calls = 100000
     for(size_t i = 0; i < args.size(); ++i)
         argv[i] = args[i].c_str();
 
-    _::logger = _arg_logger();
-    _::matcher = _matcher((int) args.size(), argv, named_calls, strict);
+    _::logger() = _arg_logger();
+    _::matcher() = _matcher((int) args.size(), argv, named_calls, strict);
 
     delete [] argv;
 }
@@ -64,8 +67,8 @@ void init_args_strict(const vector<string> &args, int named_calls) {
         ptrs[i] = arguments[i].c_str();\
     fire::argv = ptrs.data();\
     \
-    PREPARE_FIRE_(argc, argv, fired_main);\
-    fired_main();\
+    fire::parser parser(fire::argc, fire::argv);\
+    FIRE_RUN(parser, fired_main);\
 }
 
 
@@ -74,6 +77,12 @@ TEST(functions, replace_all) {
     EXPECT_EQ(replace_all("go", " ", "--"), "go");
 }
 
+TEST(functions, message) {
+    string name = "--name";
+    EXPECT_EQ(_message().str(), "");
+    EXPECT_EQ(_message("argument ", name, " at <", 3, ">", _string_view("xyz", 2)).str(), "argument --name at <3>xy");
+}
+
 TEST(optional, value) {
     fire::optional<int> no_value;
     EXPECT_FALSE((bool) no_value);
@@ -298,6 +307,148 @@ TEST(matcher, no_space_assignment) {
     EXPECT_EXIT_FAIL((void) (int) arg("-x"));
 }
 
+TEST(matcher, needs_introspection) {
+    auto needs = [](vector<const char *> args) {
+        args.insert(args.begin(), "./run_tests");
+        return _matcher::needs_introspection((int) args.size(), args.data());
+    };
+
+    EXPECT_FALSE(needs({}));
+    EXPECT_FALSE(needs({"-x=0", "--long=1", "0", "-1", "-2.5", "--flag"}));
+    EXPECT_FALSE(needs({"-a", "--", "0"}));
+    EXPECT_FALSE(needs({"--", "-x", "0", "-j8"}));
+
+    EXPECT_TRUE(needs({"-x", "0"}));
+    EXPECT_TRUE(needs({"--long", "0"}));
+    EXPECT_TRUE(needs({"-j8"}));
+    EXPECT_TRUE(needs({"-ab=0"}));
+    EXPECT_TRUE(needs({"-a", "--flag"}));
+    EXPECT_FALSE(needs({"@file"})); // Response files are opt-in
+    _::active().set_response_files(true);
+    EXPECT_TRUE(needs({"@file"}));
+    _::active().set_response_files(false);
+}
+
+TEST(matcher, many_named) {
+    const int count = 500;
+    vector<string> args = {"./run_tests"};
+    for(int i = 0; i < count; ++i)
+        args.push_back("--arg" + to_string(i) + "=" + to_string(i));
+    args.push_back("-x=0");
+    args.push_back("--both=1");
+
+    init_args_strict(args, count + 2);
+    for(int i = count - 1; i >= 0; --i) {
+        string name = "--arg" + to_string(i);
+        EXPECT_EQ((int) arg(name.c_str()), i);
+    }
+    EXPECT_EQ((int) arg({"-x", "--long-x"}), 0);
+    EXPECT_EQ((int) arg({"-b", "--both"}), 1);
+
+    init_args_strict({"./run_tests", "-x=0", "--long-x=1"}, 2);
+    EXPECT_EQ((int) arg({"-x", "--long-x"}), 0); // First occurrence is used
+    EXPECT_EXIT_FAIL((void) (int) arg("--long-x"));
+}
+
+TEST(matcher, strict_validation) {
+    vector<string> args = {"./run_tests"};
+    for(int i = 0; i < 200; ++i)
+        args.push_back("--arg" + to_string(i));
+    args.push_back("pos");
+
+    init_args_strict(args, 202);
+    for(int i = 0; i < 200; ++i)
+        EXPECT_TRUE((bool) arg(("--arg" + to_string(i)).c_str()));
+    EXPECT_EQ((string) arg(0), "pos");
+    EXPECT_EXIT_SUCCESS({ (void) (int) arg(1, 0); exit(0); });
+
+    init_args_strict(args, 200);
+    for(int i = 1; i < 200; ++i)
+        EXPECT_TRUE((bool) arg(("--arg" + to_string(i)).c_str()));
+    EXPECT_EXIT_FAIL((void) (string) arg(0)); // --arg0 is unknown
+
+    init_args_strict({"./run_tests", "--x=1", "-y", "--x=2", "--x=3"}, 2);
+    EXPECT_TRUE((bool) arg("-y"));
+    EXPECT_EXIT_FAIL((void) (int) arg("--x"));
+}
+
+TEST(matcher, scan) {
+    string long_value(100, 'x');
+    string block = string("-a=1\0--name\0---long=", 20) + long_value + string("=\0--\0\0-b\0ab=c", 13);
+    vector<_string_view> views = {_string_view(&block[0], 4), _string_view(&block[5], 6),
+                                  _string_view(&block[12], 109), _string_view(&block[122], 2),
+                                  _string_view(&block[125], 0), _string_view(&block[126], 2),
+                                  _string_view(&block[129], 2), _string_view(&block[132], 1)}; // '=' between tokens
+    const char *argv[] = {"./run_tests"};
+    _matcher matcher(1, argv, 0, false);
+    _arena_vector<_string_view> raw(views.begin(), views.end());
+    _arena_vector<_token> tokens = matcher.scan(raw);
+
+    vector<size_t> eqs = {2, _string_view::npos, 7, _string_view::npos, _string_view::npos, _string_view::npos,
+                          _string_view::npos, _string_view::npos};
+    vector<int> hyphens = {1, 2, 3, 2, 0, 1, 0, 0};
+    ASSERT_EQ(tokens.size(), views.size());
+    for(size_t i = 0; i < tokens.size(); ++i) {
+        EXPECT_EQ(tokens[i].eq, eqs[i]);
+        EXPECT_EQ(tokens[i].hyphens, hyphens[i]);
+    }
+    EXPECT_TRUE(tokens[3].separator());
+
+    swap(raw[0], raw[1]); // Not contiguous
+    tokens = matcher.scan(raw);
+    EXPECT_EQ(tokens[0].eq, eqs[1]);
+    EXPECT_EQ(tokens[1].eq, 2u);
+    EXPECT_EQ(tokens[2].eq, 7u);
+}
+
+TEST(matcher, response_files) {
+    string path = ::testing::TempDir() + "fire_response_file";
+    string nul_path = ::testing::TempDir() + "fire_response_file_nul";
+    FILE *file = fopen(path.c_str(), "wb");
+    fputs("-i=1 --name='two words'\n\t\"a \\\"b\\\"\" c\\ d 3\n", file);
+    fclose(file);
+    file = fopen(nul_path.c_str(), "wb");
+    fwrite("x y\0-f=2.5\0", 1, 11, file);
+    fclose(file);
+
+    init_args({"./run_tests", "@" + path});
+    vector<string> unexpanded = arg(variadic()); // Response files are opt-in
+    EXPECT_EQ(unexpanded, vector<string>({"@" + path}));
+
+    _::active().set_response_files(true);
+    init_args({"./run_tests", "@" + path, "--", "@" + path});
+    EXPECT_EQ((int) arg("-i"), 1);
+    EXPECT_EQ((string) arg("--name"), "two words");
+    vector<string> positional = arg(variadic());
+    EXPECT_EQ(positional, vector<string>({"a \"b\"", "c d", "3", "@" + path}));
+
+    init_args({"./run_tests", "@" + nul_path, "@" + path + "_missing"});
+    EXPECT_EQ((double) arg("-f"), 2.5);
+    positional = arg(variadic());
+    EXPECT_EQ(positional, vector<string>({"x y", "@" + path + "_missing"}));
+
+    _::active().set_response_files(false);
+    remove(path.c_str());
+    remove(nul_path.c_str());
+}
+
+TEST(matcher, empty_response_file) {
+    string path = ::testing::TempDir() + "fire_response_file_empty";
+    fclose(fopen(path.c_str(), "wb"));
+
+    _::active().set_response_files(true);
+    init_args({"./run_tests", "1", "@" + path, "2"});
+    vector<string> positional = arg(variadic());
+    EXPECT_EQ(positional, vector<string>({"1", "2"}));
+    _::active().set_response_files(false);
+
+    _arena_vector<_string_view> tokens;
+    _matcher::tokenize_response_file(nullptr, 0, tokens);
+    EXPECT_TRUE(tokens.empty());
+
+    remove(path.c_str());
+}
+
 
 TEST(help, help_invocation) {
     EXPECT_EXIT_SUCCESS(init_args_strict({"./run_tests", "-h"}, 0));
@@ -351,6 +502,18 @@ TEST(arg, argument_naming) {
     (void) arg("--a3");
 }
 
+#ifdef FIRE_STATIC_IDENTIFIERS_ENABLED_
+TEST(arg, static_identifiers) {
+    init_args_strict({"./run_tests", "--threads=4", "-v"}, 3);
+    EXPECT_EQ((int) arg(id<"-t", "--threads", "Thread count">), 4);
+    EXPECT_EQ((string) arg(id<"--name">, "default"), "default");
+    EXPECT_TRUE((bool) arg(id<"-v">));
+
+    init_args_strict({"./run_tests", "-t=1", "--threads=2"}, 1);
+    EXPECT_EQ((int) arg(id<"--threads", "-t">), 1);
+}
+#endif
+
 TEST(arg, defaults) {
     init_args({"./run_tests"});
 
@@ -437,6 +600,67 @@ TEST(arg, all_positional_parsing) {
     EXPECT_EQ(all2, vector<string>({"text"}));
 }
 
+TEST(arg, large_variadic) {
+    const int count = 100000;
+    vector<string> args = {"./run_tests"};
+    vector<long> expected;
+    for(int i = 0; i < count; ++i) {
+        args.push_back(to_string(i - count / 2));
+        expected.push_back(i - count / 2);
+    }
+
+    init_args_strict(args, 1);
+    vector<long> all = arg(variadic());
+    EXPECT_EQ(all, expected);
+
+    args.push_back("1.5");
+    init_args_strict(args, 1);
+    EXPECT_EXIT_FAIL(vector<long> invalid = arg(variadic()));
+
+    init_args_strict({"./run_tests", "0", "1"}, 2);
+    vector<int> all0 = arg(variadic());
+    EXPECT_EXIT_FAIL(vector<int> all1 = arg(variadic()));
+}
+
+TEST(arg, parallel_variadic) { // FIRE_PARALLEL_THRESHOLD is lowered for tests
+    vector<string> args = {"./run_tests"};
+    vector<double> expected;
+    for(int i = 0; i < 10000; ++i) {
+        args.push_back(to_string(i) + ".5");
+        expected.push_back(i + 0.5);
+    }
+
+    init_args_strict(args, 1);
+    vector<double> all = arg(variadic());
+    EXPECT_EQ(all, expected);
+
+    args[9000] = "second";
+    args[5000] = "first";
+    init_args_strict(args, 1);
+    EXPECT_EXIT(vector<double> invalid = arg(variadic()), ::testing::ExitedWithCode(_failure_code),
+                "value first is not a real number");
+}
+
+TEST(arg, variadic_range) {
+    init_args_strict({"./run_tests", "3", "-1", "x"}, 1);
+    arg_range<string> strings = arg(variadic());
+    EXPECT_EQ(strings.size(), 3u);
+    EXPECT_EQ(vector<string>(strings.begin(), strings.end()), vector<string>({"3", "-1", "x"}));
+
+    init_args_strict({"./run_tests", "3", "-1", "x"}, 1);
+    arg_range<int> ints = arg(variadic());
+    EXPECT_EQ(ints[0] + ints[1], 2);
+    EXPECT_EXIT_FAIL((void) ints[2]);
+
+    init_args_strict({"./run_tests", "3", "x"}, 1);
+    EXPECT_EXIT_FAIL((void) (arg_range<int, true>) arg(variadic()));
+
+    init_args_strict({"./run_tests"}, 1);
+    arg_range<double, true> empty = arg(variadic());
+    EXPECT_TRUE(empty.empty());
+    EXPECT_EQ(empty.begin(), empty.end());
+}
+
 TEST(arg, double_dash_separator) {
     init_args({"./run_tests", "--"});
     vector<string> all0 = arg(variadic());
@@ -475,6 +699,120 @@ TEST(arg, precision) {
     EXPECT_EXIT_FAIL((void) (float) arg("-a", 1e100));
 }
 
+TEST(arg, integer_parsing) {
+    init_args({
+        "./run_tests",
+        "--u64-max=18446744073709551615",
+        "--u64-overflow=18446744073709551616",
+        "--i64-min=-9223372036854775808",
+        "--i64-underflow=-9223372036854775809",
+        "--hex=0xFFff",
+        "--octal=0o17",
+        "--binary=-0b101",
+        "--separated=1_000_000",
+        "--leading-zeros=000000000000000000000000000042",
+        "--bad-separator1=1__000",
+        "--bad-separator2=1000_",
+        "--bad-separator3=_1000",
+        "--bad-hex=0xG",
+        "--empty=",
+        "--sign-only=-",
+        "--prefix-only=0x",
+        "0x10",
+        "1_000"
+    });
+
+    EXPECT_EQ((uint64_t) arg("--u64-max"), 18446744073709551615ULL);
+    EXPECT_EXIT_FAIL((void) (uint64_t) arg("--u64-overflow"));
+    EXPECT_EQ((int64_t) arg("--i64-min"), std::numeric_limits<int64_t>::lowest());
+    EXPECT_EXIT_FAIL((void) (int64_t) arg("--i64-underflow"));
+    EXPECT_EXIT_FAIL((void) (int) arg("--hex")); // Literal syntax is opt-in
+    EXPECT_EXIT_FAIL((void) (int) arg("--separated"));
+    EXPECT_EXIT_FAIL((void) (vector<int>) arg(variadic()));
+
+    _::active().set_integer_literals(true);
+    EXPECT_EQ((int) arg("--hex"), 0xFFFF);
+    EXPECT_EXIT_FAIL((void) (int16_t) arg("--hex"));
+    EXPECT_EQ((int) arg("--octal"), 15);
+    EXPECT_EQ((int) arg("--binary"), -5);
+    EXPECT_EXIT_FAIL((void) (unsigned) arg("--binary"));
+    EXPECT_EQ((int) arg("--separated"), 1000000);
+    EXPECT_EQ((vector<int>) arg(variadic()), vector<int>({16, 1000}));
+    EXPECT_EQ((uint8_t) arg("--leading-zeros"), 42);
+
+    EXPECT_EXIT_FAIL((void) (int) arg("--bad-separator1"));
+    EXPECT_EXIT_FAIL((void) (int) arg("--bad-separator2"));
+    EXPECT_EXIT_FAIL((void) (int) arg("--bad-separator3"));
+    EXPECT_EXIT_FAIL((void) (int) arg("--bad-hex"));
+    EXPECT_EXIT_FAIL((void) (int) arg("--empty"));
+    EXPECT_EXIT_FAIL((void) (int) arg("--sign-only"));
+    EXPECT_EXIT_FAIL((void) (int) arg("--prefix-only"));
+    _::active().set_integer_literals(false);
+
+    for(int64_t expected: {0LL, 1LL, -1LL, 12345678LL, 123456789LL, -1234567890123456789LL, 9223372036854775807LL}) {
+        string str = to_string(expected);
+        init_args({"./run_tests", "-x=" + str});
+        EXPECT_EQ((int64_t) arg("-x"), expected);
+    }
+
+#ifdef FIRE_INT128_ENABLED_
+    init_args({"./run_tests", "--max=170141183460469231731687303715884105727",
+               "--overflow=170141183460469231731687303715884105728",
+               "--umax=0xffffffffffffffffffffffffffffffff"});
+    EXPECT_TRUE((_int128) arg("--max") == (_int128) (((_uint128) 1 << 127) - 1));
+    EXPECT_EXIT_FAIL((void) (_int128) arg("--overflow"));
+    _::active().set_integer_literals(true);
+    EXPECT_TRUE((_uint128) arg("--umax") == ~(_uint128) 0);
+    _::active().set_integer_literals(false);
+#endif
+}
+
+TEST(arg, real_parsing) {
+    init_args({"./run_tests", "--exact=0.1", "--exp=-1.5e-3", "--upper=2E+2", "--point=.5", "--trailing=5.",
+               "--long-mantissa=3.14159265358979323846264338327950288", "--double-max=1.7976931348623157e308",
+               "--double-overflow=1e309", "--denormal=4.9e-324", "--underflow=1e-400", "--float-overflow=3.5e38",
+               "--no-exp-digits=1e", "--two-points=1.2.3", "--exp-only=e5", "--inf=inf", "--nan=nan",
+               "--negative-underflow=-1e-400", "--total-underflow=1e-5000", "--hex=0x1p3"});
+
+    EXPECT_EQ((double) arg("--exact"), 0.1);
+    EXPECT_EQ((float) arg("--exact"), 0.1f);
+    EXPECT_EQ((double) arg("--exp"), -1.5e-3);
+    EXPECT_EQ((double) arg("--upper"), 200.0);
+    EXPECT_EQ((double) arg("--point"), 0.5);
+    EXPECT_EQ((double) arg("--trailing"), 5.0);
+    EXPECT_EQ((double) arg("--long-mantissa"), 3.14159265358979323846264338327950288);
+    EXPECT_EQ((double) arg("--double-max"), std::numeric_limits<double>::max());
+    EXPECT_EXIT_FAIL((void) (double) arg("--double-overflow"));
+    EXPECT_EQ((double) arg("--denormal"), 4.9e-324);
+    if(std::numeric_limits<long double>::min_exponent10 < -400) { // Narrowed to zero, as by a cast
+        EXPECT_EQ((double) arg("--underflow"), 0.0);
+        EXPECT_EQ((float) arg("--underflow"), 0.0f);
+        EXPECT_TRUE(std::signbit((double) arg("--negative-underflow")));
+    } else {
+        EXPECT_EXIT_FAIL((void) (double) arg("--underflow"));
+    }
+    EXPECT_EXIT_FAIL((void) (double) arg("--total-underflow")); // Underflows even long double
+    EXPECT_EXIT_FAIL((void) (long double) arg("--total-underflow"));
+    EXPECT_EXIT_FAIL((void) (float) arg("--float-overflow"));
+
+    EXPECT_EXIT_FAIL((void) (double) arg("--no-exp-digits"));
+    EXPECT_EXIT_FAIL((void) (double) arg("--two-points"));
+    EXPECT_EXIT_FAIL((void) (double) arg("--exp-only"));
+    EXPECT_EXIT_FAIL((void) (double) arg("--inf"));
+    EXPECT_EXIT_FAIL((void) (double) arg("--nan"));
+    EXPECT_EXIT_FAIL((void) (double) arg("--hex")); // Only decimal notation
+
+    // Correct rounding, compared to strtod/strtof
+    mt19937_64 rng(0);
+    for(int i = 0; i < 10000; ++i) {
+        char str[64];
+        snprintf(str, sizeof(str), "%.*g", (int) (rng() % 20 + 1), (double) (rng() % 1000000007) / (double) (rng() % 1000 + 1));
+        init_args({"./run_tests", string("-x=") + str});
+        EXPECT_EQ((double) arg("-x"), strtod(str, nullptr));
+        EXPECT_EQ((float) arg("-x"), strtof(str, nullptr));
+    }
+}
+
 bool dashed_values_inside = false;
 
 int dashed_values_main(int x = arg("-x"), int y = arg("-y"), string z = arg("-z"),
@@ -593,7 +931,7 @@ TEST(logger, assignement_arguments) {
     (void) (float) arg("--float");
     (void) (bool) arg("--bool");
 
-    vector<string> args = _::logger.get_assignment_arguments();
+    vector<string> args = _::logger().get_assignment_arguments();
     EXPECT_NE(find(args.begin(), args.end(), "-i"), args.end());
     EXPECT_NE(find(args.begin(), args.end(), "--int"), args.end());
     EXPECT_NE(find(args.begin(), args.end(), "-s"), args.end());
@@ -601,6 +939,21 @@ TEST(logger, assignement_arguments) {
     EXPECT_EQ(find(args.begin(), args.end(), "--bool"), args.end());
 }
 
+TEST(logger, assignment_table) {
+    _assignment_table table(vector<string>({"-i", "--int", "-s", "--float-value"}));
+    EXPECT_TRUE(table.contains("-i"));
+    EXPECT_TRUE(table.contains("--int"));
+    EXPECT_TRUE(table.contains("--float-value"));
+    EXPECT_FALSE(table.contains("-f"));
+    EXPECT_FALSE(table.contains("--in"));
+    EXPECT_FALSE(table.contains("i"));
+    EXPECT_FALSE(table.contains("--"));
+
+    _assignment_table moved = std::move(table);
+    EXPECT_TRUE(moved.contains("-s"));
+    EXPECT_TRUE(moved.contains("--float-value"));
+}
+
 bool ambiguous_args_inside1 = false;
 int ambiguous_args_main1(int x = arg("-x")) {
     EXPECT_EQ(x, 1);
@@ -673,3 +1026,119 @@ TEST(argc_argv, values)
   CALL_WITH_INTROSPECTION(argc_argv_values_main, args);
   EXPECT_TRUE(argc_argv_values_inside);
 }
+
+int parser_main(int x = arg("-x"), vector<int> rest = arg(variadic())) {
+    for(int value: rest)
+        x += value;
+    return x;
+}
+
+TEST(parser, concurrent) {
+    vector<thread> threads;
+    vector<int> results(8);
+    for(int t = 0; t < (int) results.size(); ++t) {
+        threads.emplace_back([t, &results] {
+            for(int i = 0; i < 100; ++i) {
+                string x = to_string(t), value = to_string(i);
+                vector<const char *> argv = {"./run_tests", "-x", x.c_str(), value.c_str(), "1"};
+                fire::parser parser((int) argv.size(), argv.data());
+                results[t] += FIRE_RUN(parser, parser_main) - t - 1;
+            }
+        });
+    }
+    for(thread &t: threads)
+        t.join();
+
+    for(int result: results)
+        EXPECT_EQ(result, 99 * 100 / 2);
+}
+
+TEST(parser, arena) {
+    alignas(16) char memory[256];
+    _arena arena(memory, sizeof(memory));
+    char *small = (char *) arena.allocate(100, 1);
+    EXPECT_EQ(small, memory);
+    EXPECT_EQ((size_t) arena.allocate(8, 8) % 8, 0u);
+    char *large = (char *) arena.allocate(1000, 1); // Doesn't fit, continues on the heap
+    EXPECT_TRUE(large < memory || large >= memory + sizeof(memory));
+
+    arena.reset();
+    EXPECT_EQ(arena.allocate(100, 1), small);
+    EXPECT_EQ(arena.allocate(1000, 1), large); // Heap blocks are reused
+
+    vector<char> buffer(1 << 12);
+    vector<const char *> argv = {"./run_tests", "-x", "1", "2", "3"};
+    fire::parser parser((int) argv.size(), argv.data(), buffer.data(), buffer.size());
+    for(int i = 0; i < 3; ++i)
+        EXPECT_EQ(FIRE_RUN(parser, parser_main), 6);
+}
+
+TEST(parser, returns_on_error) {
+    // Help and errors end FIRE_RUN instead of the host process
+    vector<vector<const char *>> failing = {{"./run_tests", "-x=oops"}, {"./run_tests"}, {"./run_tests", "-x=1", "-y"}};
+    for(vector<const char *> &argv: failing) {
+        fire::parser parser((int) argv.size(), argv.data());
+        testing::internal::CaptureStderr();
+        EXPECT_EQ(FIRE_RUN(parser, parser_main), _failure_code);
+        EXPECT_NE(testing::internal::GetCapturedStderr().find("Error: "), string::npos);
+    }
+
+    vector<const char *> help = {"./run_tests", "-h"};
+    fire::parser help_parser((int) help.size(), help.data());
+    testing::internal::CaptureStderr();
+    EXPECT_EQ(FIRE_RUN(help_parser, parser_main), 0);
+    EXPECT_NE(testing::internal::GetCapturedStderr().find("Usage:"), string::npos);
+
+    vector<const char *> valid = {"./run_tests", "-x", "1", "2"};
+    fire::parser parser((int) valid.size(), valid.data());
+    EXPECT_EQ(FIRE_RUN(parser, parser_main), 3);
+    EXPECT_EQ(_::current, nullptr);
+}
+
+int parser_range_main(arg_range<int> values = arg(variadic())) {
+    int sum = 0;
+    try {
+        for(int value: values)
+            sum += value;
+    } catch (...) { // Must not stop the error
+    }
+    return sum;
+}
+
+TEST(parser, exits_on_error_in_body) {
+    vector<const char *> valid = {"./run_tests", "1", "2"};
+    fire::parser valid_parser((int) valid.size(), valid.data());
+    EXPECT_EQ(FIRE_RUN(valid_parser, parser_range_main), 3);
+
+    vector<const char *> argv = {"./run_tests", "1", "2", "x", "4"};
+    fire::parser parser((int) argv.size(), argv.data());
+    EXPECT_EXIT_FAIL(FIRE_RUN(parser, parser_range_main));
+}
+
+#if defined(FIRE_STATS) && defined(FIRE_MMAP_ENABLED_)
+TEST(parser, stats) {
+    char path[] = "/tmp/fire_stats_XXXXXX";
+    int fd = mkstemp(path);
+    ASSERT_GE(fd, 0);
+    close(fd);
+    setenv("FIRE_STATS", path, 1);
+    vector<const char *> argv = {"./run_tests", "-x", "1", "2", "3"};
+    fire::parser parser((int) argv.size(), argv.data());
+    unsetenv("FIRE_STATS");
+    EXPECT_EQ(FIRE_RUN(parser, parser_main), 6);
+    EXPECT_EQ(FIRE_RUN(parser, parser_main), 6);
+
+    ifstream file(path);
+    vector<string> lines;
+    for(string line; getline(file, line);)
+        lines.push_back(line);
+    remove(path);
+    ASSERT_EQ(lines.size(), 2u);
+    for(const string &line: lines) {
+        EXPECT_EQ(line.front(), '{');
+        EXPECT_NE(line.find("\"named\": 1, \"positional\": 2, \"options\": 2,"), string::npos);
+        for(const char *key: {"introspect_ns", "parse_ns", "convert_ns", "check_ns", "arena_bytes", "heap_blocks"})
+            EXPECT_NE(line.find(key), string::npos);
+    }
+}
+#endif